@@ -0,0 +1,47 @@
+-- Check that the batched render mode draws through one mesh.
+
+local nuklear = require 'nuklear'
+local stub = require 'stub'
+
+local ui = nuklear.newUI()
+ui:setRenderMode('batched')
+
+ui:frameBegin()
+if ui:windowBegin('Batched', 10, 10, 200, 200, 'border') then
+	local x, y = ui:windowGetBounds()
+	ui:setColor('#ff0000')
+	ui:line(x + 10, y + 40, x + 50, y + 40, x + 50, y + 80)
+	ui:circle('fill', x + 130, y + 140, 30)
+	ui:rectMultiColor(x + 95, y + 50, 50, 50, '#ff0000', '#00ff00', '#000000', '#0000ff')
+end
+ui:windowEnd()
+ui:frameEnd()
+
+stub.reset()
+ui:draw()
+
+for _, name in ipairs {'rectangle', 'polygon', 'line', 'ellipse', 'arc', 'print'} do
+	assert(not stub.counts[name], 'batched draw called love.graphics.' .. name)
+end
+assert(#stub.draws > 0, 'nothing was drawn')
+
+local mesh = stub.draws[1].mesh
+assert(mesh.vertexCount and mesh.vertexCount > 0, 'no vertices were uploaded')
+
+local next = 1
+for i, draw in ipairs(stub.draws) do
+	assert(draw.mesh == mesh, 'draw ' .. i .. ' used another mesh')
+	assert(draw.first == next, 'draw ' .. i .. ' does not follow the previous range')
+	for j = draw.first, draw.first + draw.count - 1 do
+		assert(mesh.map[j] < mesh.vertexCount, 'draw ' .. i .. ' indexes past the vertices')
+	end
+	next = draw.first + draw.count
+	local previous = stub.draws[i - 1]
+	if previous then
+		assert(previous.scissor ~= draw.scissor or previous.texture ~= draw.texture,
+			'draws ' .. (i - 1) .. ' and ' .. i .. ' could have been merged')
+	end
+end
+
+print(string.format('batched: ok, %d vertices, %d elements in %d draws',
+	mesh.vertexCount, next - 1, #stub.draws))
@@ -0,0 +1,41 @@
+-- Measure the cost of individual widget calls.
+--
+--   LUA_CPATH='build/?.so' love example/headless bench_calls [calls]
+--
+-- To compare two builds, for example before and after a change or with and
+-- without LOVE_NUKLEAR_TRUSTED, run this once against each and compare the
+-- printed times.
+
+local nuklear = require 'nuklear'
+
+local calls = {
+	{'label', function (ui) ui:label('Label') end},
+	{'button', function (ui) ui:button('Button') end},
+	{'checkbox', function (ui, state) ui:checkbox('Checkbox', state) end},
+	{'layoutRow', function (ui) ui:layoutRow('dynamic', 20, 1) end},
+	{'windowGetBounds', function (ui) ui:windowGetBounds() end},
+	{'setColor', function (ui) ui:setColor('#ff0000') end}
+}
+
+return function (n)
+	n = tonumber(n) or 100000
+	local ui = nuklear.newUI()
+	local state = {value = false}
+	for _, call in ipairs(calls) do
+		local name, f = call[1], call[2]
+		local best = math.huge
+		for _ = 1, 5 do
+			ui:frameBegin()
+			ui:windowBegin('Calls', 0, 0, 400, 400, 'scrollbar')
+			ui:layoutRow('dynamic', 20, 1)
+			local start = love.timer.getTime()
+			for _ = 1, n do
+				f(ui, state)
+			end
+			best = math.min(best, love.timer.getTime() - start)
+			ui:windowEnd()
+			ui:frameEnd()
+		end
+		print(string.format('%-16s %8.1f ns per call', name, best / n * 1e9))
+	end
+end
@@ -0,0 +1,54 @@
+-- Measure the latency of typing at the start of a 10 MB document.
+--
+--   love example/headless bench_document [keystrokes]
+
+local nuklear = require 'nuklear'
+
+return function (keystrokes)
+	keystrokes = tonumber(keystrokes) or 200
+
+	local ui = nuklear.newUI()
+	local line = string.rep('x', 79) .. '\n'
+	local doc = ui:newDocument(string.rep(line, 10 * 1024 * 1024 / #line))
+
+	local function frame()
+		ui:frameBegin()
+		if ui:windowBegin('Document', 0, 0, 800, 600) then
+			ui:layoutRow('dynamic', 560, 1)
+			ui:document(doc)
+		end
+		ui:windowEnd()
+		ui:frameEnd()
+		ui:draw()
+	end
+
+	frame()
+	ui:mousepressed(20, 10, 1, false)
+	frame()
+	ui:mousereleased(20, 10, 1, false)
+	ui:keypressed('home', 'home', false)
+	frame()
+	ui:keyreleased('home', 'home')
+	frame()
+
+	local length = doc:getLength()
+	local times = {}
+	for i = 1, keystrokes do
+		ui:textinput('a')
+		local start = love.timer.getTime()
+		frame()
+		times[i] = love.timer.getTime() - start
+	end
+	assert(doc:getLength() == length + keystrokes, 'not every keystroke was inserted')
+	assert(doc:getLine(1):sub(1, keystrokes) == string.rep('a', keystrokes),
+		'keystrokes were not inserted at the start')
+
+	table.sort(times)
+	local total = 0
+	for _, t in ipairs(times) do
+		total = total + t
+	end
+	print(string.format('%d bytes, %d keystrokes: mean %.1f us, median %.1f us, max %.1f us',
+		length, keystrokes, total / keystrokes * 1e6,
+		times[math.ceil(keystrokes / 2)] * 1e6, times[keystrokes] * 1e6))
+end
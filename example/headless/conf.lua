@@ -0,0 +1,12 @@
+-- Run without a window or a graphics module; main.lua stubs love.graphics.
+
+function love.conf(t)
+	t.window = false
+	t.modules.window = false
+	t.modules.graphics = false
+	t.modules.audio = false
+	t.modules.sound = false
+	t.modules.joystick = false
+	t.modules.physics = false
+	t.modules.video = false
+end
@@ -0,0 +1,40 @@
+-- Check that ui:rectMultiColor puts each color on its own corner in both
+-- render modes.
+
+local nuklear = require 'nuklear'
+local stub = require 'stub'
+
+local corners = {
+	{name = 'top left', dx = 0, dy = 0, color = '#ff0000ff'},
+	{name = 'top right', dx = 50, dy = 0, color = '#00ff00ff'},
+	{name = 'bottom left', dx = 0, dy = 50, color = '#0000ffff'},
+	{name = 'bottom right', dx = 50, dy = 50, color = '#000000ff'}
+}
+
+local ui = nuklear.newUI()
+
+for _, mode in ipairs {'immediate', 'batched'} do
+	ui:setRenderMode(mode)
+	local x, y
+	ui:frameBegin()
+	if ui:windowBegin('Corners', 10, 10, 200, 200, 'border') then
+		x, y = ui:windowGetBounds()
+		x, y = x + 20, y + 20
+		ui:rectMultiColor(x, y, 50, 50, '#ff0000', '#00ff00', '#0000ff', '#000000')
+	end
+	ui:windowEnd()
+	ui:frameEnd()
+
+	stub.reset()
+	ui:draw()
+
+	for _, corner in ipairs(corners) do
+		local colors = stub.colorsAt(x + corner.dx, y + corner.dy)
+		assert(colors[corner.color], mode .. ': ' .. corner.name .. ' is not ' .. corner.color)
+		for _, other in ipairs(corners) do
+			assert(other == corner or not colors[other.color],
+				mode .. ': ' .. corner.name .. ' has the ' .. other.name .. ' color')
+		end
+	end
+	print('corners: ' .. mode .. ' ok')
+end
@@ -0,0 +1,59 @@
+-- Check selection, copy, cut and paste in ui:document.
+
+local nuklear = require 'nuklear'
+local stub = require 'stub'
+
+local ui = nuklear.newUI()
+local doc = ui:newDocument('hello world\nsecond line')
+
+local function frame()
+	ui:frameBegin()
+	if ui:windowBegin('Document', 0, 0, 400, 300) then
+		ui:layoutRow('dynamic', 200, 1)
+		ui:document(doc)
+	end
+	ui:windowEnd()
+	ui:frameEnd()
+end
+
+local function press(key, ctrl)
+	stub.ctrl = ctrl or false
+	ui:keypressed(key, key, false)
+	frame()
+	ui:keyreleased(key, key)
+	frame()
+	stub.ctrl = false
+end
+
+frame()
+ui:mousepressed(40, 10, 1, false)
+frame()
+ui:mousereleased(40, 10, 1, false)
+frame()
+press('home')
+
+ui:keypressed('lshift', 'lshift', false)
+for _ = 1, 5 do
+	press('right')
+end
+ui:keyreleased('lshift', 'lshift')
+frame()
+
+press('c', true)
+assert(stub.clipboard == 'hello', 'copied ' .. stub.clipboard)
+press('x', true)
+assert(doc:getText() == ' world\nsecond line', 'cut left ' .. doc:getText())
+
+press('end')
+press('v', true)
+assert(doc:getText() == ' worldhello\nsecond line', 'paste left ' .. doc:getText())
+
+ui:keypressed('lshift', 'lshift', false)
+press('down')
+ui:keyreleased('lshift', 'lshift')
+frame()
+ui:textinput('!')
+frame()
+assert(doc:getText() == ' worldhello!', 'typing over the selection left ' .. doc:getText())
+
+print('document: ok')
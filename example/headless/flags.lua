@@ -0,0 +1,21 @@
+-- Check that window flags given as a table leave the other arguments alone.
+
+local nuklear = require 'nuklear'
+
+local ui = nuklear.newUI()
+
+ui:frameBegin()
+assert(ui:windowBegin('Flags', 0, 0, 300, 300, {'border', 'title'}), 'window did not open')
+ui:layoutRow('dynamic', 200, 1)
+local first, count = ui:listViewBegin('list', {'border'}, 20, 1000)
+assert(first == 1 and count and count > 0, 'list view did not open')
+ui:listViewEnd()
+ui:layoutRow('dynamic', 200, 1)
+assert(ui:groupBegin('group', {'border', 'scrollbar'}), 'group did not open')
+ui:groupEnd()
+local ok, err = pcall(ui.groupBegin, ui, 'bad', {'border', 'nonsense'})
+assert(not ok and err:find("unrecognized window flag 'nonsense'"), 'bad flag was accepted')
+ui:windowEnd()
+ui:frameEnd()
+
+print('flags: ok')
@@ -0,0 +1,33 @@
+-- Check text measurement with and without Font:getKerning.
+
+local nuklear = require 'nuklear'
+local stub = require 'stub'
+
+local function measure(font)
+	stub.font = font
+	local ui = nuklear.newUI()
+	ui:frameBegin()
+	if ui:windowBegin('Fonts', 0, 0, 300, 300) then
+		ui:layoutRow('dynamic', 20, 1)
+		ui:label('kerning test')
+		ui:button('kerning test')
+	end
+	ui:windowEnd()
+	ui:frameEnd()
+	ui:draw()
+	local whole = false
+	for _, text in ipairs(font.widths) do
+		whole = whole or text == 'kerning test'
+	end
+	return whole
+end
+
+-- LÖVE 11 fonts have no getKerning, so whole strings are measured.
+assert(measure(stub.newFont(14)), 'text was not measured as a whole without getKerning')
+
+-- With getKerning, glyph advances and kerning pairs are cached instead.
+local kerned = stub.newFont(14, true)
+assert(not measure(kerned), 'text was measured as a whole with getKerning')
+assert(kerned.kernings > 0, 'getKerning was never called')
+
+print('fonts: ok')
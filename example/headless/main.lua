@@ -0,0 +1,27 @@
+-- Headless checks and benchmarks for LÖVE-Nuklear.
+--
+-- Run one of the scripts in this folder with
+--   LUA_CPATH='/path/to/build/?.so' love example/headless <script>
+-- Scripts report with print, and failed checks exit with status 1.
+
+local stub = require 'stub'
+
+function love.load(args)
+	local name = args[1]
+	if not name then
+		print('usage: love example/headless <script> [args...]')
+		os.exit(1)
+	end
+	stub.install()
+	local ok, err = xpcall(function ()
+		local script = require(name)
+		if type(script) == 'function' then
+			script(select(2, unpack(args)))
+		end
+	end, debug.traceback)
+	if not ok then
+		print(err)
+		os.exit(1)
+	end
+	os.exit(0)
+end
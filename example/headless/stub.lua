@@ -0,0 +1,201 @@
+-- A recording stand-in for love.graphics, love.keyboard and love.system.
+--
+-- love.data and love.timer are left alone, so ByteData pointers handed to
+-- the batched renderer are real and can be read back through the FFI.
+
+local ffi = require 'ffi'
+
+ffi.cdef [[
+typedef struct {
+	float x, y, u, v;
+	uint8_t r, g, b, a;
+} nk_love_stub_vertex;
+]]
+
+local stub = {}
+
+-- The binding only accepts userdata as LÖVE objects, so fields are reached
+-- through a proxy.
+local function object(kind, fields)
+	fields = fields or {}
+	function fields:typeOf(name)
+		return name == kind or name == 'Object' or name == 'Drawable'
+			or (kind == 'Canvas' and name == 'Texture')
+	end
+	function fields:type()
+		return kind
+	end
+	local proxy = newproxy(true)
+	local meta = getmetatable(proxy)
+	meta.__index = fields
+	meta.__newindex = fields
+	return proxy
+end
+
+local function hex(r, g, b, a)
+	return string.format('#%02x%02x%02x%02x', r, g, b, a)
+end
+
+-- Fonts are 7 pixels per byte. Like LÖVE 11, they have no getKerning unless
+-- kerning is set, in which case every pair of glyphs is kerned by -1. Every
+-- string measured with getWidth is recorded in widths.
+function stub.newFont(height, kerning)
+	local fields = {widths = {}, kernings = 0}
+	function fields.getHeight()
+		return height
+	end
+	function fields.getWidth(_, text)
+		text = tostring(text)
+		table.insert(fields.widths, text)
+		local n = #text:gsub('[\128-\191]', '')
+		return #text * 7 + (kerning and math.min(0, 1 - n) or 0)
+	end
+	if kerning then
+		function fields.getKerning()
+			fields.kernings = fields.kernings + 1
+			return -1
+		end
+	end
+	return object('Font', fields)
+end
+
+local function newMesh(format, count, mode)
+	if type(format) == 'number' then
+		format, count, mode = nil, format, count
+	end
+	local mesh = object('Mesh', {vertices = {}, map = {}, mode = mode})
+	-- Immediate mode sets vertices one at a time with 0..1 colors.
+	function mesh:setVertex(i, x, y, u, v, r, g, b, a)
+		local function byte(c) return math.floor(c * 255 + 0.5) end
+		self.vertices[i] = {x = x, y = y, color = hex(byte(r), byte(g), byte(b), byte(a))}
+	end
+	-- The batched renderer uploads packed vertices and a uint32 vertex map.
+	function mesh:setVertices(data, start, n)
+		local v = ffi.cast('nk_love_stub_vertex *', data:getPointer())
+		for i = 0, n - 1 do
+			self.vertices[start + i] = {x = v[i].x, y = v[i].y,
+				color = hex(v[i].r, v[i].g, v[i].b, v[i].a)}
+		end
+		self.vertexCount = n
+	end
+	function mesh:setVertexMap(data, kind)
+		assert(kind == 'uint32', 'unexpected vertex map type')
+		local p = ffi.cast('uint32_t *', data:getPointer())
+		self.map = {}
+		for i = 0, data:getSize() / 4 - 1 do
+			self.map[i + 1] = p[i]
+		end
+	end
+	function mesh:setTexture(texture)
+		self.texture = texture
+	end
+	function mesh:setDrawRange(first, n)
+		self.first, self.count = first, n
+	end
+	return mesh
+end
+
+local graphics = {}
+
+function graphics.getFont()
+	return stub.font
+end
+
+function graphics.getColor()
+	return 1, 1, 1, 1
+end
+
+function graphics.getLineWidth()
+	return 1
+end
+
+function graphics.getScissor()
+	if stub.scissor then
+		return unpack(stub.scissor)
+	end
+end
+
+function graphics.setScissor(x, y, w, h)
+	stub.scissor = x and {x, y, w, h} or nil
+end
+
+function graphics.newMesh(...)
+	local mesh = newMesh(...)
+	table.insert(stub.meshes, mesh)
+	return mesh
+end
+
+function graphics.newCanvas(w, h)
+	local canvas = object('Canvas', {width = w, height = h})
+	function canvas:getDimensions()
+		return self.width, self.height
+	end
+	return canvas
+end
+
+function graphics.draw(drawable)
+	if drawable.vertices then
+		table.insert(stub.draws, {
+			mesh = drawable,
+			first = drawable.first,
+			count = drawable.count,
+			texture = drawable.texture,
+			scissor = stub.scissor and table.concat(stub.scissor, ',') or 'none'
+		})
+	end
+end
+
+-- Clears everything recorded so far.
+function stub.reset()
+	stub.counts = {}
+	stub.draws = {}
+	stub.meshes = {}
+	stub.scissor = nil
+end
+
+function stub.install()
+	stub.font = stub.newFont(14)
+	stub.ctrl = false
+	stub.clipboard = ''
+	stub.reset()
+	-- Every love.graphics function is counted; those not defined above
+	-- do nothing.
+	love.graphics = setmetatable({}, {__index = function (t, name)
+		local impl = graphics[name] or function () end
+		local f = function (...)
+			stub.counts[name] = (stub.counts[name] or 0) + 1
+			return impl(...)
+		end
+		rawset(t, name, f)
+		return f
+	end})
+	love.keyboard = {
+		isScancodeDown = function (scancode)
+			return stub.ctrl and scancode == 'lctrl'
+		end
+	}
+	love.system = {
+		getClipboardText = function () return stub.clipboard end,
+		setClipboardText = function (text) stub.clipboard = text end
+	}
+end
+
+-- Returns the set of colors drawn at (x, y) since the last reset.
+function stub.colorsAt(x, y)
+	local colors, seen = {}, {}
+	for _, draw in ipairs(stub.draws) do
+		local mesh = draw.mesh
+		if not seen[mesh] then
+			seen[mesh] = true
+			for i = 1, mesh.vertexCount or #mesh.vertices do
+				local v = mesh.vertices[i]
+				if v.x == x and v.y == y then
+					colors[v.color] = true
+				end
+			end
+		end
+	end
+	return colors
+end
+
+return stub
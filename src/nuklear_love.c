@@ -18,6 +18,8 @@
 #define NK_INCLUDE_STANDARD_IO
 #define NK_INCLUDE_STANDARD_VARARGS
 #define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_UINT_DRAW_INDEX
 #define NK_PRIVATE
 #define NK_BUTTON_BEHAVIOR_STACK_SIZE 32
 #define NK_FONT_STACK_SIZE 32
@@ -36,35 +38,341 @@
  * ===============================================================
  */
 
-#define NK_LOVE_MAX_POINTS 1024
-#define NK_LOVE_EDIT_BUFFER_LEN (1024 * 1024)
-#define NK_LOVE_COMBOBOX_MAX_ITEMS 1024
-#define NK_LOVE_MAX_FONTS 1024
-#define NK_LOVE_MAX_RATIOS 1024
+#define NK_LOVE_EDIT_SLACK 4096
+#define NK_LOVE_DOCUMENT_GAP 4096
+#define NK_LOVE_DOCUMENT_LINE_GAP 256
+#define NK_LOVE_MIN_ARENA_BLOCK 4096
+#define NK_LOVE_MIN_BATCH_VERTICES 1024
+#define NK_LOVE_MIN_BATCH_ELEMENTS 4096
+#define NK_LOVE_SEGMENT_COUNT 22
+#define NK_LOVE_MIN_SEGMENTS 8
+#define NK_LOVE_MAX_SEGMENTS 512
+#define NK_LOVE_DEFAULT_TESSELLATION_ERROR 0.5f
+#define NK_LOVE_GLYPH_TABLE_SIZE 256
+#define NK_LOVE_MIN_METRIC_CAPACITY 64
+#define NK_LOVE_MAX_CACHED_WINDOWS 64
+#define NK_LOVE_MIN_IMAGE_CAPACITY 64
+#define NK_LOVE_MIN_FONT_CAPACITY 8
+#define NK_LOVE_MAX_TRANSFORMS 64
+#define NK_LOVE_MAX_LIST_VIEWS 16
+#define NK_LOVE_MAX_PENS 32
+#define NK_LOVE_MAX_STYLE_DEPTH 64
+#define NK_LOVE_MAX_SERIES_LEVELS 64
+#define NK_LOVE_ENUM_SLOTS 256
+#define NK_LOVE_COLOR_CACHE_SIZE 64
+#define NK_LOVE_TEXT_CACHE_SIZE 512
+#define NK_LOVE_CANVAS_PADDING 2
+
+static float *unit_circles[NK_LOVE_MAX_SEGMENTS / 4 + 1];
+static const void *context_metatable;
+
+enum nk_love_graphics_function {
+	NK_LOVE_GRAPHICS_ARC,
+	NK_LOVE_GRAPHICS_CLEAR,
+	NK_LOVE_GRAPHICS_DRAW,
+	NK_LOVE_GRAPHICS_ELLIPSE,
+	NK_LOVE_GRAPHICS_GET_SCISSOR,
+	NK_LOVE_GRAPHICS_LINE,
+	NK_LOVE_GRAPHICS_NEW_CANVAS,
+	NK_LOVE_GRAPHICS_NEW_MESH,
+	NK_LOVE_GRAPHICS_ORIGIN,
+	NK_LOVE_GRAPHICS_POLYGON,
+	NK_LOVE_GRAPHICS_POP,
+	NK_LOVE_GRAPHICS_PRINT,
+	NK_LOVE_GRAPHICS_PUSH,
+	NK_LOVE_GRAPHICS_RECTANGLE,
+	NK_LOVE_GRAPHICS_ROTATE,
+	NK_LOVE_GRAPHICS_SCALE,
+	NK_LOVE_GRAPHICS_SET_BLEND_MODE,
+	NK_LOVE_GRAPHICS_SET_CANVAS,
+	NK_LOVE_GRAPHICS_SET_COLOR,
+	NK_LOVE_GRAPHICS_SET_FONT,
+	NK_LOVE_GRAPHICS_SET_LINE_WIDTH,
+	NK_LOVE_GRAPHICS_SET_SCISSOR,
+	NK_LOVE_GRAPHICS_SHEAR,
+	NK_LOVE_GRAPHICS_TRANSLATE,
+	NK_LOVE_GRAPHICS_FUNCTION_COUNT
+};
+
+static const char *nk_love_graphics_names[NK_LOVE_GRAPHICS_FUNCTION_COUNT] = {
+	[NK_LOVE_GRAPHICS_ARC] = "arc",
+	[NK_LOVE_GRAPHICS_CLEAR] = "clear",
+	[NK_LOVE_GRAPHICS_DRAW] = "draw",
+	[NK_LOVE_GRAPHICS_ELLIPSE] = "ellipse",
+	[NK_LOVE_GRAPHICS_GET_SCISSOR] = "getScissor",
+	[NK_LOVE_GRAPHICS_LINE] = "line",
+	[NK_LOVE_GRAPHICS_NEW_CANVAS] = "newCanvas",
+	[NK_LOVE_GRAPHICS_NEW_MESH] = "newMesh",
+	[NK_LOVE_GRAPHICS_ORIGIN] = "origin",
+	[NK_LOVE_GRAPHICS_POLYGON] = "polygon",
+	[NK_LOVE_GRAPHICS_POP] = "pop",
+	[NK_LOVE_GRAPHICS_PRINT] = "print",
+	[NK_LOVE_GRAPHICS_PUSH] = "push",
+	[NK_LOVE_GRAPHICS_RECTANGLE] = "rectangle",
+	[NK_LOVE_GRAPHICS_ROTATE] = "rotate",
+	[NK_LOVE_GRAPHICS_SCALE] = "scale",
+	[NK_LOVE_GRAPHICS_SET_BLEND_MODE] = "setBlendMode",
+	[NK_LOVE_GRAPHICS_SET_CANVAS] = "setCanvas",
+	[NK_LOVE_GRAPHICS_SET_COLOR] = "setColor",
+	[NK_LOVE_GRAPHICS_SET_FONT] = "setFont",
+	[NK_LOVE_GRAPHICS_SET_LINE_WIDTH] = "setLineWidth",
+	[NK_LOVE_GRAPHICS_SET_SCISSOR] = "setScissor",
+	[NK_LOVE_GRAPHICS_SHEAR] = "shear",
+	[NK_LOVE_GRAPHICS_TRANSLATE] = "translate"
+};
+
+/* Registry refs to the love.graphics functions used by the renderer. */
+static int graphics_refs[NK_LOVE_GRAPHICS_FUNCTION_COUNT];
+static int graphics_resolved;
+
+struct nk_love_metric_entry {
+	unsigned long long key;
+	float value;
+};
+
+struct nk_love_metric_map {
+	struct nk_love_metric_entry *entries;
+	unsigned int capacity;
+	unsigned int count;
+};
 
-static char *edit_buffer;
-static const char **combobox_items;
-static float *points;
+struct nk_love_font_metrics {
+	float advances[NK_LOVE_GLYPH_TABLE_SIZE];
+	struct nk_love_metric_map glyphs;
+	struct nk_love_metric_map kerning;
+	int has_kerning;
+};
 
 struct nk_love_handle {
 	lua_State *L;
 	int ref;
+	struct nk_love_font_metrics *metrics;
 };
 
 struct nk_love_font {
 	struct nk_user_font font;
 	struct nk_love_handle handle;
+	unsigned int frame;
+};
+
+enum nk_love_render_mode {NK_LOVE_RENDER_IMMEDIATE, NK_LOVE_RENDER_BATCHED};
+enum nk_love_draw_mode {NK_LOVE_FILL, NK_LOVE_LINE};
+
+struct nk_love_vertex {
+	float position[2];
+	float uv[2];
+	nk_byte col[4];
+};
+
+static const struct nk_draw_vertex_layout_element nk_love_vertex_layout[] = {
+	{NK_VERTEX_POSITION, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_love_vertex, position)},
+	{NK_VERTEX_TEXCOORD, NK_FORMAT_FLOAT, NK_OFFSETOF(struct nk_love_vertex, uv)},
+	{NK_VERTEX_COLOR, NK_FORMAT_R8G8B8A8, NK_OFFSETOF(struct nk_love_vertex, col)},
+	{NK_VERTEX_LAYOUT_END}
+};
+
+struct nk_love_batch {
+	struct nk_draw_list list;
+	struct nk_convert_config config;
+	struct nk_buffer cmds;
+	struct nk_buffer vertices;
+	struct nk_buffer elements;
+	unsigned int vertex_capacity;
+	unsigned int element_capacity;
+};
+
+struct nk_love_graphics_state {
+	int has_color, has_line_width, has_font, has_scissor;
+	struct nk_color color;
+	int line_width;
+	int font_ref;
+	int scissor[4];
+};
+
+struct nk_love_stats {
+	unsigned int state_changes;
+	unsigned int state_changes_skipped;
+	unsigned int glyph_hits;
+	unsigned int glyph_misses;
+	unsigned int window_cache_hits;
+	unsigned int window_renders;
+	int heap_growth;
+};
+
+struct nk_love_transform {
+	enum nk_love_graphics_function function;
+	int argc;
+	float args[2];
+};
+
+/*
+ * Per-frame scratch memory. Allocations are bumped from a chain of blocks
+ * that double in size and are released together at ui:frameBegin, when all
+ * but the newest block are freed.
+ */
+struct nk_love_arena_block {
+	struct nk_love_arena_block *next;
+	size_t size;
+	size_t used;
+};
+
+struct nk_love_arena {
+	struct nk_love_arena_block *blocks;
+	size_t used;
+	size_t high_water;
+};
+
+struct nk_love_pen {
+	struct nk_color color;
+	float line_width;
+};
+
+struct nk_love_image_slot {
+	struct nk_image image;
+	unsigned int frame;
+	int used;
+	int plain;
+	int pinned;
+};
+
+struct nk_love_text_buffer {
+	struct nk_text_edit edit;
+	int length;
+	short undo_point, redo_point;
+	unsigned int version;
+};
+
+/*
+ * Large documents keep their text in a gap buffer at the last edit position.
+ * Line starts before the line gap are absolute byte offsets, those after it
+ * count back from the end of the text, so edits never shift the line index.
+ * The selection runs between the anchor and the cursor.
+ */
+struct nk_love_document {
+	char *text;
+	size_t capacity, gap_start, gap_end;
+	size_t *lines;
+	size_t line_capacity, line_gap_start, line_gap_end;
+	char *scratch;
+	size_t scratch_capacity;
+	size_t cursor, anchor, scroll;
+	unsigned int version;
+	int active, selecting;
+};
+
+struct nk_love_item_list {
+	char *text;
+	const char **items;
+	nk_uint *masks;
+	int *matches;
+	int count, match_count;
+	char *query;
+	size_t query_len;
+	int filtered;
+	unsigned int version;
+};
+
+/*
+ * A retained sample buffer with a min/max pyramid. Level k > 0 holds one
+ * (min, max) pair for every 2^k samples, so the extremes of any range are
+ * found in O(log n).
+ */
+struct nk_love_series {
+	float *samples;
+	float *pyramid;
+	size_t levels[NK_LOVE_MAX_SERIES_LEVELS];
+	int level_count;
+	int count;
+	unsigned int version;
+};
+
+/*
+ * A compiled style is a list of values for fields of struct nk_style, each
+ * stored with its field offset. Pushing a style saves the old field values
+ * on the context and copies the new values in. Popping copies the saved
+ * values back. Images and fonts are kept in the style's environment table
+ * and interned again on every push.
+ */
+enum nk_love_style_kind {
+	NK_LOVE_STYLE_COLOR,
+	NK_LOVE_STYLE_VEC2,
+	NK_LOVE_STYLE_ITEM,
+	NK_LOVE_STYLE_FLAGS,
+	NK_LOVE_STYLE_FLOAT,
+	NK_LOVE_STYLE_FONT
+};
+
+union nk_love_style_value {
+	struct nk_color color;
+	struct nk_vec2 vec2;
+	struct nk_style_item item;
+	nk_flags flags;
+	float f;
+	const struct nk_user_font *font;
+};
+
+struct nk_love_style_entry {
+	enum nk_love_style_kind kind;
+	size_t offset;
+	int ref;
+	union nk_love_style_value value;
+};
+
+struct nk_love_style {
+	struct nk_love_style_entry *entries;
+	int count, capacity;
+};
+
+struct nk_love_window_cache {
+	nk_hash name;
+	nk_hash hash;
+	int valid;
+	int x, y, w, h;
+	nk_size begin, end;
+	int popup;
 };
 
 static struct nk_love_context {
 	struct nk_context nkctx;
-	struct nk_love_font *fonts;
+	struct nk_love_font **fonts;
 	int font_count;
-	float *layout_ratios;
-	int layout_ratio_count;
+	int font_capacity;
 	float T[9];
 	float Ti[9];
+	struct nk_love_transform transforms[NK_LOVE_MAX_TRANSFORMS];
+	int transform_count;
 	int transform_allowed;
+	struct nk_list_view list_views[NK_LOVE_MAX_LIST_VIEWS];
+	int list_view_count;
+	struct nk_love_pen pen;
+	struct nk_love_pen pens[NK_LOVE_MAX_PENS];
+	int pen_count;
+	int pen_sync;
+	const struct nk_user_font *pen_font;
+	struct nk_love_style_entry *style_saves;
+	int style_save_count;
+	int style_save_capacity;
+	int style_marks[NK_LOVE_MAX_STYLE_DEPTH];
+	int style_depth;
+	int style_frame_depth;
+	int *style_images;
+	int style_image_count;
+	int style_image_capacity;
+	unsigned int style_generation;
+	unsigned int style_scan;
+	struct nk_love_arena arena;
+	enum nk_love_render_mode render_mode;
+	struct nk_love_batch batch;
+	struct nk_love_graphics_state state;
+	struct nk_love_stats stats;
+	struct nk_love_window_cache *window_caches;
+	int window_cache_count;
+	int edit_changed;
+	float tessellation_error;
+	struct nk_love_image_slot *images;
+	int image_capacity;
+	unsigned int frame;
+	int heap_start;
 } *context;
 
 static void nk_love_assert(lua_State *L, int pass, const char *msg)
@@ -80,10 +388,18 @@ static void nk_love_assert(lua_State *L, int pass, const char *msg)
 	}
 }
 
+/*
+ * Builds with NK_LOVE_TRUSTED defined skip argument count checks. Calls with
+ * the wrong number of arguments are then undefined.
+ */
+#ifdef NK_LOVE_TRUSTED
+#define nk_love_assert_argc(L, pass) ((void) (L), (void) sizeof(pass))
+#else
 static void nk_love_assert_argc(lua_State *L, int pass)
 {
 	nk_love_assert(L, pass, "wrong number of arguments to '%s'");
 }
+#endif
 
 static void nk_love_assert_alloc(lua_State *L, void *mem)
 {
@@ -97,27 +413,81 @@ static void *nk_love_malloc(lua_State *L, size_t size)
 	return mem;
 }
 
+static void *nk_love_arena_alloc(lua_State *L, size_t size)
+{
+	struct nk_love_arena *arena = &context->arena;
+	struct nk_love_arena_block *block = arena->blocks;
+	size = (size + 7) & ~(size_t) 7;
+	if (block == NULL || block->size - block->used < size) {
+		size_t block_size = NK_MAX(size, block ? block->size * 2 : NK_LOVE_MIN_ARENA_BLOCK);
+		struct nk_love_arena_block *grown = nk_love_malloc(L, sizeof(struct nk_love_arena_block) + block_size);
+		grown->next = block;
+		grown->size = block_size;
+		grown->used = 0;
+		arena->blocks = block = grown;
+	}
+	void *mem = (char *) (block + 1) + block->used;
+	block->used += size;
+	arena->used += size;
+	arena->high_water = NK_MAX(arena->high_water, arena->used);
+	return mem;
+}
+
+static void nk_love_arena_reset(struct nk_love_arena *arena)
+{
+	struct nk_love_arena_block *block = arena->blocks;
+	if (block == NULL)
+		return;
+	while (block->next != NULL) {
+		struct nk_love_arena_block *next = block->next->next;
+		free(block->next);
+		block->next = next;
+	}
+	block->used = 0;
+	arena->used = 0;
+}
+
+static int nk_love_heap_size(lua_State *L)
+{
+	return lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+}
+
 static struct nk_love_context *nk_love_checkcontext(lua_State *L, int index)
 {
 	if (index < 0)
 		index += lua_gettop(L) + 1;
-	if (lua_isuserdata(L, index)) {
-		lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
-		lua_getfield(L, -1, "metatable");
-		lua_getmetatable(L, index);
-		int is_context = lua_equal(L, -1, -2);
-		lua_pop(L, 3);
+	if (lua_type(L, index) == LUA_TUSERDATA && lua_getmetatable(L, index)) {
+		int is_context = lua_topointer(L, -1) == context_metatable;
+		lua_pop(L, 1);
 		if (is_context)
 			return lua_touserdata(L, index);
 	}
 	luaL_typerror(L, index, "Nuklear context");
 }
 
+static void *nk_love_toudata(lua_State *L, int index, const char *meta)
+{
+	if (index < 0)
+		index += lua_gettop(L) + 1;
+	if (!lua_isuserdata(L, index))
+		return NULL;
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_getfield(L, -1, meta);
+	if (!lua_getmetatable(L, index))
+		lua_pushnil(L);
+	int is_type = lua_equal(L, -1, -2);
+	lua_pop(L, 3);
+	return is_type ? lua_touserdata(L, index) : NULL;
+}
+
 static void nk_love_assert_context(lua_State *L, int index)
 {
-	struct nk_love_context *ctx = nk_love_checkcontext(L, index);
+	struct nk_love_context *ctx = lua_touserdata(L, index);
+	if (ctx == NULL || ctx != context) {
+		ctx = nk_love_checkcontext(L, index);
+		nk_love_assert(L, ctx == context, "%s: UI calls must reside between ui:frameBegin and ui:frameEnd");
+	}
 	ctx->transform_allowed = 0;
-	nk_love_assert(L, ctx == context, "%s: UI calls must reside between ui:frameBegin and ui:frameEnd");
 }
 
 static void nk_love_assert_transform(lua_State *L)
@@ -157,28 +527,218 @@ static int nk_love_is_type(lua_State *L, int index, const char *type)
 	return 0;
 }
 
-static float nk_love_get_text_width(nk_handle handle, float height,
-	const char *text, int len)
+static int nk_love_metric_get(struct nk_love_metric_map *map,
+	unsigned long long key, float *value)
+{
+	if (map->capacity == 0)
+		return 0;
+	unsigned int mask = map->capacity - 1;
+	unsigned int i = (unsigned int) (key ^ (key >> 29)) * 2654435761u & mask;
+	while (map->entries[i].key) {
+		if (map->entries[i].key == key + 1) {
+			*value = map->entries[i].value;
+			return 1;
+		}
+		i = (i + 1) & mask;
+	}
+	return 0;
+}
+
+static void nk_love_metric_insert(struct nk_love_metric_map *map,
+	unsigned long long key, float value)
+{
+	unsigned int mask = map->capacity - 1;
+	unsigned int i = (unsigned int) (key ^ (key >> 29)) * 2654435761u & mask;
+	while (map->entries[i].key)
+		i = (i + 1) & mask;
+	map->entries[i].key = key + 1;
+	map->entries[i].value = value;
+	map->count++;
+}
+
+static void nk_love_metric_set(lua_State *L, struct nk_love_metric_map *map,
+	unsigned long long key, float value)
+{
+	if ((map->count + 1) * 2 > map->capacity) {
+		struct nk_love_metric_map grown;
+		grown.capacity = NK_MAX(map->capacity * 2, NK_LOVE_MIN_METRIC_CAPACITY);
+		grown.count = 0;
+		grown.entries = calloc(grown.capacity, sizeof(struct nk_love_metric_entry));
+		nk_love_assert_alloc(L, grown.entries);
+		unsigned int i;
+		for (i = 0; i < map->capacity; ++i) {
+			if (map->entries[i].key)
+				nk_love_metric_insert(&grown, map->entries[i].key - 1,
+					map->entries[i].value);
+		}
+		free(map->entries);
+		*map = grown;
+	}
+	nk_love_metric_insert(map, key, value);
+}
+
+static int nk_love_metrics_gc(lua_State *L)
+{
+	struct nk_love_font_metrics *metrics = lua_touserdata(L, 1);
+	free(metrics->glyphs.entries);
+	free(metrics->kerning.entries);
+	return 0;
+}
+
+static void nk_love_count_glyph(int hit)
+{
+	if (context == NULL)
+		return;
+	if (hit)
+		context->stats.glyph_hits++;
+	else
+		context->stats.glyph_misses++;
+}
+
+static void nk_love_push_text(lua_State *L, const char *text, int len)
+{
+	int slot = nk_murmur_hash(text, len, 0) % NK_LOVE_TEXT_CACHE_SIZE + 1;
+	lua_pushlstring(L, text, len);
+	nk_love_pushregistry(L, "text");
+	lua_pushvalue(L, -2);
+	lua_rawseti(L, -2, slot);
+	lua_pop(L, 1);
+}
+
+static float nk_love_font_width(lua_State *L, int ref, const char *text, int len)
 {
-	struct nk_love_handle *love_handle = handle.ptr;
-	lua_State *L = love_handle->L;
 	nk_love_pushregistry(L, "font");
-	lua_rawgeti(L, -1, love_handle->ref);
+	lua_rawgeti(L, -1, ref);
 	lua_getfield(L, -1, "getWidth");
 	lua_replace(L, -3);
-	lua_pushlstring(L, text, len);
+	nk_love_push_text(L, text, len);
 	lua_call(L, 2, 1);
 	float width = lua_tonumber(L, -1);
 	lua_pop(L, 1);
 	return width;
 }
 
-static void nk_love_checkFont(lua_State *L, int index, struct nk_love_font *font)
+static float nk_love_glyph_advance(struct nk_love_handle *love_handle,
+	nk_rune rune, const char *glyph, int len)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	if (!nk_love_is_type(L, index, "Font"))
-		luaL_typerror(L, index, "Font");
+	struct nk_love_font_metrics *metrics = love_handle->metrics;
+	float advance;
+	if (rune < NK_LOVE_GLYPH_TABLE_SIZE) {
+		advance = metrics->advances[rune];
+		nk_love_count_glyph(advance >= 0);
+		if (advance < 0) {
+			advance = nk_love_font_width(love_handle->L, love_handle->ref, glyph, len);
+			metrics->advances[rune] = advance;
+		}
+	} else if (nk_love_metric_get(&metrics->glyphs, rune, &advance)) {
+		nk_love_count_glyph(1);
+	} else {
+		nk_love_count_glyph(0);
+		advance = nk_love_font_width(love_handle->L, love_handle->ref, glyph, len);
+		nk_love_metric_set(love_handle->L, &metrics->glyphs, rune, advance);
+	}
+	return advance;
+}
+
+static float nk_love_glyph_kerning(struct nk_love_handle *love_handle,
+	nk_rune left, nk_rune right)
+{
+	struct nk_love_font_metrics *metrics = love_handle->metrics;
+	unsigned long long key = ((unsigned long long) left << 32) | right;
+	float kerning;
+	if (nk_love_metric_get(&metrics->kerning, key, &kerning)) {
+		nk_love_count_glyph(1);
+		return kerning;
+	}
+	nk_love_count_glyph(0);
+	lua_State *L = love_handle->L;
+	nk_love_pushregistry(L, "font");
+	lua_rawgeti(L, -1, love_handle->ref);
+	lua_getfield(L, -1, "getKerning");
+	lua_replace(L, -3);
+	lua_pushnumber(L, left);
+	lua_pushnumber(L, right);
+	lua_call(L, 3, 1);
+	kerning = lua_tonumber(L, -1);
+	lua_pop(L, 1);
+	nk_love_metric_set(L, &metrics->kerning, key, kerning);
+	return kerning;
+}
+
+static float nk_love_get_text_width(nk_handle handle, float height,
+	const char *text, int len)
+{
+	struct nk_love_handle *love_handle = handle.ptr;
+	/* Without Font:getKerning, summed advances would miss the kerning that
+	 * getWidth includes, so measure the whole string instead. */
+	if (!love_handle->metrics->has_kerning)
+		return nk_love_font_width(love_handle->L, love_handle->ref, text, len);
+	float width = 0;
+	nk_rune previous = 0;
+	int i = 0;
+	while (i < len) {
+		nk_rune rune;
+		int glyph_len = nk_utf_decode(text + i, &rune, len - i);
+		if (glyph_len == 0 || rune == NK_UTF_INVALID || rune == '\n'
+				|| rune == '\r' || rune == '\t')
+			return nk_love_font_width(love_handle->L, love_handle->ref, text, len);
+		width += nk_love_glyph_advance(love_handle, rune, text + i, glyph_len);
+		if (previous)
+			width += nk_love_glyph_kerning(love_handle, previous, rune);
+		previous = rune;
+		i += glyph_len;
+	}
+	return width;
+}
+
+static struct nk_love_font_metrics *nk_love_font_metrics(lua_State *L, int index)
+{
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_getfield(L, -1, "metrics");
+	lua_pushvalue(L, index);
+	lua_rawget(L, -2);
+	struct nk_love_font_metrics *metrics = lua_touserdata(L, -1);
+	if (metrics == NULL) {
+		lua_pop(L, 1);
+		metrics = lua_newuserdata(L, sizeof(struct nk_love_font_metrics));
+		int i;
+		for (i = 0; i < NK_LOVE_GLYPH_TABLE_SIZE; ++i)
+			metrics->advances[i] = -1;
+		memset(&metrics->glyphs, 0, sizeof(metrics->glyphs));
+		memset(&metrics->kerning, 0, sizeof(metrics->kerning));
+		lua_getfield(L, index, "getKerning");
+		metrics->has_kerning = lua_isfunction(L, -1);
+		lua_pop(L, 1);
+		lua_getfield(L, -3, "metricsmeta");
+		lua_setmetatable(L, -2);
+		lua_pushvalue(L, index);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, -4);
+	}
+	lua_pop(L, 3);
+	return metrics;
+}
+
+static struct nk_love_font *nk_love_intern_font(lua_State *L, int index)
+{
+	int slot;
+	for (slot = 0; slot < context->font_count; ++slot) {
+		if (context->fonts[slot]->handle.ref == LUA_NOREF)
+			break;
+	}
+	if (slot == context->font_count) {
+		if (context->font_count == context->font_capacity) {
+			int capacity = NK_MAX(context->font_capacity * 2, NK_LOVE_MIN_FONT_CAPACITY);
+			struct nk_love_font **fonts = realloc(context->fonts,
+				sizeof(struct nk_love_font *) * capacity);
+			nk_love_assert_alloc(L, fonts);
+			context->fonts = fonts;
+			context->font_capacity = capacity;
+		}
+		context->fonts[slot] = nk_love_malloc(L, sizeof(struct nk_love_font));
+		context->font_count++;
+	}
+	struct nk_love_font *font = context->fonts[slot];
 	nk_love_pushregistry(L, "font");
 	lua_pushvalue(L, index);
 	int ref = luaL_ref(L, -2);
@@ -188,100 +748,329 @@ static void nk_love_checkFont(lua_State *L, int index, struct nk_love_font *font
 	float height = lua_tonumber(L, -1);
 	font->handle.L = L;
 	font->handle.ref = ref;
+	font->handle.metrics = nk_love_font_metrics(L, index);
 	font->font.userdata.ptr = &font->handle;
 	font->font.height = height;
 	font->font.width = nk_love_get_text_width;
 	lua_pop(L, 2);
+	nk_love_pushregistry(L, "fontid");
+	lua_pushvalue(L, index);
+	lua_pushinteger(L, slot);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+	return font;
 }
 
-static void nk_love_checkImage(lua_State *L, int index, struct nk_image *image)
+static struct nk_love_font *nk_love_checkFont(lua_State *L, int index)
 {
 	if (index < 0)
 		index += lua_gettop(L) + 1;
-	if (nk_love_is_type(L, index, "Image") || nk_love_is_type(L, index, "Canvas")) {
-		lua_getglobal(L, "love");
-		lua_getfield(L, -1, "graphics");
-		lua_getfield(L, -1, "newQuad");
-		lua_pushnumber(L, 0);
-		lua_pushnumber(L, 0);
-		lua_getfield(L, index, "getDimensions");
-		lua_pushvalue(L, index);
-		lua_call(L, 1, 2);
+	struct nk_love_font *font;
+	nk_love_pushregistry(L, "fontid");
+	lua_pushvalue(L, index);
+	lua_rawget(L, -2);
+	if (lua_isnumber(L, -1)) {
+		font = context->fonts[lua_tointeger(L, -1)];
+		lua_pop(L, 2);
+	} else {
+		lua_pop(L, 2);
+		if (!nk_love_is_type(L, index, "Font"))
+			luaL_typerror(L, index, "Font");
+		font = nk_love_intern_font(L, index);
+	}
+	font->frame = context->frame;
+	return font;
+}
+
+static void nk_love_release_fonts(lua_State *L)
+{
+	int slot;
+	for (slot = 0; slot < context->font_count; ++slot) {
+		struct nk_love_font *font = context->fonts[slot];
+		if (font->handle.ref == LUA_NOREF || font->frame + 1 >= context->frame)
+			continue;
+		nk_love_pushregistry(L, "font");
+		nk_love_pushregistry(L, "fontid");
+		lua_rawgeti(L, -2, font->handle.ref);
+		lua_pushnil(L);
+		lua_rawset(L, -3);
+		lua_pop(L, 1);
+		luaL_unref(L, -1, font->handle.ref);
+		lua_pop(L, 1);
+		font->handle.ref = LUA_NOREF;
+	}
+}
+
+static int nk_love_find_image(lua_State *L, int image, int key)
+{
+	if (image < 0)
+		image += lua_gettop(L) + 1;
+	if (key < 0)
+		key += lua_gettop(L) + 1;
+	int id = 0;
+	nk_love_pushregistry(L, "imageid");
+	lua_pushvalue(L, image);
+	lua_rawget(L, -2);
+	if (lua_istable(L, -1)) {
+		lua_pushvalue(L, key);
+		lua_rawget(L, -2);
+		id = lua_tointeger(L, -1);
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 2);
+	return id;
+}
+
+static int nk_love_intern_image(lua_State *L, const struct nk_image *image, int plain)
+{
+	nk_love_pushregistry(L, "image");
+	lua_pushvalue(L, -2);
+	int id = luaL_ref(L, -2);
+	lua_pop(L, 1);
+	nk_love_pushregistry(L, "imageid");
+	lua_rawgeti(L, -2, 1);
+	lua_pushvalue(L, -1);
+	lua_rawget(L, -3);
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		lua_newtable(L);
 		lua_pushvalue(L, -2);
 		lua_pushvalue(L, -2);
-		lua_call(L, 6, 1);
-		lua_newtable(L);
-		lua_pushvalue(L, index);
-		lua_rawseti(L, -2, 1);
-		lua_replace(L, -3);
-		lua_rawseti(L, -2, 2);
-		lua_replace(L, -2);
-	} else if (lua_istable(L, index)) {
-		lua_createtable(L, 2, 0);
-		lua_rawgeti(L, index, 2);
+		lua_rawset(L, -5);
+	}
+	if (plain)
+		lua_pushvalue(L, -2);
+	else
+		lua_rawgeti(L, -4, 2);
+	lua_pushinteger(L, id);
+	lua_rawset(L, -3);
+	lua_pop(L, 4);
+	if (id >= context->image_capacity) {
+		int capacity = NK_MAX(context->image_capacity * 2, NK_LOVE_MIN_IMAGE_CAPACITY);
+		capacity = NK_MAX(capacity, id + 1);
+		struct nk_love_image_slot *images = realloc(context->images,
+			sizeof(struct nk_love_image_slot) * capacity);
+		nk_love_assert_alloc(L, images);
+		memset(images + context->image_capacity, 0,
+			sizeof(struct nk_love_image_slot) * (capacity - context->image_capacity));
+		context->images = images;
+		context->image_capacity = capacity;
+	}
+	struct nk_love_image_slot *slot = &context->images[id];
+	slot->image = *image;
+	slot->image.handle = nk_handle_id(id);
+	slot->used = 1;
+	slot->pinned = 0;
+	slot->plain = plain;
+	return id;
+}
+
+static void nk_love_release_images(lua_State *L)
+{
+	int id;
+	for (id = 0; id < context->image_capacity; ++id) {
+		struct nk_love_image_slot *slot = &context->images[id];
+		if (!slot->used || slot->pinned || slot->frame + 1 >= context->frame)
+			continue;
+		nk_love_pushregistry(L, "image");
+		lua_rawgeti(L, -1, id);
+		nk_love_pushregistry(L, "imageid");
+		lua_rawgeti(L, -2, 1);
+		lua_rawget(L, -2);
+		if (lua_istable(L, -1)) {
+			if (slot->plain)
+				lua_rawgeti(L, -3, 1);
+			else
+				lua_rawgeti(L, -3, 2);
+			lua_pushnil(L);
+			lua_rawset(L, -3);
+		}
+		lua_pop(L, 3);
+		luaL_unref(L, -1, id);
+		lua_pop(L, 1);
+		slot->used = 0;
+	}
+}
+
+static void nk_love_checkImage(lua_State *L, int index, struct nk_image *image)
+{
+	if (index < 0)
+		index += lua_gettop(L) + 1;
+	int id;
+	if (lua_istable(L, index)) {
 		lua_rawgeti(L, index, 1);
-		if ((nk_love_is_type(L, -1, "Image") || nk_love_is_type(L, -1, "Canvas")) && nk_love_is_type(L, -2, "Quad")) {
-			lua_rawseti(L, -3, 1);
+		lua_rawgeti(L, index, 2);
+		id = nk_love_find_image(L, -2, -1);
+		lua_pop(L, 2);
+	} else {
+		id = nk_love_find_image(L, index, index);
+	}
+	if (id == 0) {
+		struct nk_image checked;
+		int plain = !lua_istable(L, index);
+		if (nk_love_is_type(L, index, "Image") || nk_love_is_type(L, index, "Canvas")) {
+			lua_getglobal(L, "love");
+			lua_getfield(L, -1, "graphics");
+			lua_getfield(L, -1, "newQuad");
+			lua_pushnumber(L, 0);
+			lua_pushnumber(L, 0);
+			lua_getfield(L, index, "getDimensions");
+			lua_pushvalue(L, index);
+			lua_call(L, 1, 2);
+			checked.w = checked.region[2] = lua_tonumber(L, -2);
+			checked.h = checked.region[3] = lua_tonumber(L, -1);
+			checked.region[0] = checked.region[1] = 0;
+			lua_pushvalue(L, -2);
+			lua_pushvalue(L, -2);
+			lua_call(L, 6, 1);
+			lua_newtable(L);
+			lua_pushvalue(L, index);
+			lua_rawseti(L, -2, 1);
+			lua_replace(L, -3);
 			lua_rawseti(L, -2, 2);
+			lua_replace(L, -2);
+		} else if (lua_istable(L, index)) {
+			lua_createtable(L, 2, 0);
+			lua_rawgeti(L, index, 2);
+			lua_rawgeti(L, index, 1);
+			if ((nk_love_is_type(L, -1, "Image") || nk_love_is_type(L, -1, "Canvas")) && nk_love_is_type(L, -2, "Quad")) {
+				lua_getfield(L, -2, "getViewport");
+				lua_pushvalue(L, -3);
+				lua_call(L, 1, 4);
+				lua_getfield(L, -6, "getTextureDimensions");
+				lua_pushvalue(L, -7);
+				lua_call(L, 1, 2);
+				checked.region[0] = lua_tonumber(L, -6);
+				checked.region[1] = lua_tonumber(L, -5);
+				checked.region[2] = lua_tonumber(L, -4);
+				checked.region[3] = lua_tonumber(L, -3);
+				checked.w = lua_tonumber(L, -2);
+				checked.h = lua_tonumber(L, -1);
+				lua_pop(L, 6);
+				lua_rawseti(L, -3, 1);
+				lua_rawseti(L, -2, 2);
+			} else {
+				luaL_argerror(L, index, "expecting {Image, Quad} or {Canvas, Quad}");
+			}
 		} else {
-			luaL_argerror(L, index, "expecting {Image, Quad} or {Canvas, Quad}");
+			luaL_argerror(L, index, "expecting Image or Canvas or {Image, Quad} or {Canvas, Quad}");
 		}
-	} else {
-		luaL_argerror(L, index, "expecting Image or Canvas or {Image, Quad} or {Canvas, Quad}");
+		id = nk_love_intern_image(L, &checked, plain);
 	}
-	nk_love_pushregistry(L, "image");
-	lua_pushvalue(L, -2);
-	int ref = luaL_ref(L, -2);
-	image->handle = nk_handle_id(ref);
-	lua_pop(L, 2);
+	context->images[id].frame = context->frame;
+	*image = context->images[id].image;
 }
 
-static int nk_love_is_hex(char c)
+/*
+ * Colors are '#rrggbb' or '#rrggbbaa' strings, numbers packed as 0xrrggbbaa,
+ * or {r, g, b, [a]} tables with components from 0 to 255. Parsed strings are
+ * cached by address; a slot only hits when its text matches as well.
+ */
+static struct nk_love_color_slot {
+	char text[10];
+	struct nk_color color;
+} color_cache[NK_LOVE_COLOR_CACHE_SIZE];
+
+static int nk_love_hex(char c)
 {
-	return (c >= '0' && c <= '9')
-			|| (c >= 'a' && c <= 'f')
-			|| (c >= 'A' && c <= 'F');
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	else if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	else if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	else
+		return -1;
 }
 
-static int nk_love_is_color(lua_State *L, int index)
+static int nk_love_parse_color(const char *color_string, size_t len, struct nk_color *color)
+{
+	if ((len != 7 && len != 9) || color_string[0] != '#')
+		return 0;
+	nk_byte components[4] = {0, 0, 0, 255};
+	size_t i;
+	for (i = 1; i < len; i += 2) {
+		int hi = nk_love_hex(color_string[i]);
+		int lo = nk_love_hex(color_string[i + 1]);
+		if (hi < 0 || lo < 0)
+			return 0;
+		components[i / 2] = (nk_byte) (hi * 16 + lo);
+	}
+	*color = nk_rgba(components[0], components[1], components[2], components[3]);
+	return 1;
+}
+
+static int nk_love_tocolor(lua_State *L, int index, struct nk_color *color)
 {
 	if (index < 0)
 		index += lua_gettop(L) + 1;
-	if (lua_isstring(L, index)) {
+	switch (lua_type(L, index)) {
+	case LUA_TSTRING: {
 		size_t len;
 		const char *color_string = lua_tolstring(L, index, &len);
-		if ((len == 7 || len == 9) && color_string[0] == '#') {
-			int i;
-			for (i = 1; i < len; ++i) {
-				if (!nk_love_is_hex(color_string[i]))
-					return 0;
-			}
+		/* Empty cache slots hold "", so reject bad shapes before the lookup. */
+		if ((len != 7 && len != 9) || color_string[0] != '#')
+			return 0;
+		struct nk_love_color_slot *slot = &color_cache[((size_t) color_string >> 4)
+				& (NK_LOVE_COLOR_CACHE_SIZE - 1)];
+		if (!memcmp(slot->text, color_string, len + 1)) {
+			*color = slot->color;
 			return 1;
 		}
+		if (!nk_love_parse_color(color_string, len, color))
+			return 0;
+		memcpy(slot->text, color_string, len + 1);
+		slot->color = *color;
+		return 1;
 	}
-	return 0;
+	case LUA_TNUMBER: {
+		lua_Number n = lua_tonumber(L, index);
+		if (n < 0 || n > 4294967295.0)
+			return 0;
+		nk_uint packed = (nk_uint) n;
+		*color = nk_rgba((packed >> 24) & 0xff, (packed >> 16) & 0xff,
+				(packed >> 8) & 0xff, packed & 0xff);
+		return 1;
+	}
+	case LUA_TTABLE: {
+		int i, components[4] = {0, 0, 0, 255};
+		for (i = 0; i < 4; ++i) {
+			lua_rawgeti(L, index, i + 1);
+			if (lua_type(L, -1) == LUA_TNUMBER)
+				components[i] = (int) lua_tonumber(L, -1);
+			else if (i < 3 || !lua_isnil(L, -1)) {
+				lua_pop(L, 1);
+				return 0;
+			}
+			lua_pop(L, 1);
+		}
+		*color = nk_rgba(components[0], components[1], components[2], components[3]);
+		return 1;
+	}
+	default:
+		return 0;
+	}
+}
+
+static int nk_love_is_color(lua_State *L, int index)
+{
+	struct nk_color color;
+	return nk_love_tocolor(L, index, &color);
 }
 
 static struct nk_color nk_love_checkcolor(lua_State *L, int index)
 {
 	if (index < 0)
 		index += lua_gettop(L) + 1;
-	if (!nk_love_is_color(L, index)) {
-		if (lua_isstring(L, index)){
+	struct nk_color color;
+	if (!nk_love_tocolor(L, index, &color)) {
+		if (lua_type(L, index) == LUA_TSTRING) {
 			const char *msg = lua_pushfstring(L, "bad color string '%s'", lua_tostring(L, index));
 			luaL_argerror(L, index, msg);
 		} else {
-			luaL_typerror(L, index, "color string");
+			luaL_typerror(L, index, "color");
 		}
 	}
-	size_t len;
-	const char *color_string = lua_tolstring(L, index, &len);
-	int r, g, b, a = 255;
-	sscanf(color_string, "#%02x%02x%02x", &r, &g, &b);
-	if (len == 9) {
-		sscanf(color_string + 7, "%02x", &a);
-	}
-	struct nk_color color = {r, g, b, a};
 	return color;
 }
 
@@ -304,254 +1093,295 @@ static void nk_love_color(int r, int g, int b, int a, char *color_string)
 	sprintf(color_string, format_string, r, g, b, a);
 }
 
+static lua_Number nk_love_pack_color(struct nk_color color)
+{
+	return (lua_Number) (((nk_uint) color.r << 24) | ((nk_uint) color.g << 16)
+			| ((nk_uint) color.b << 8) | (nk_uint) color.a);
+}
+
+static void nk_love_pushcolor(lua_State *L, struct nk_color color, int packed)
+{
+	if (packed) {
+		lua_pushnumber(L, nk_love_pack_color(color));
+	} else {
+		char color_string[10];
+		nk_love_color(color.r, color.g, color.b, color.a, color_string);
+		lua_pushstring(L, color_string);
+	}
+}
+
+/*
+ * String enums are resolved through a hash keyed by the interned string
+ * pointer. Every name below is anchored in the registry, so any Lua string
+ * with the same contents is the same object and compares equal by pointer.
+ * Strings from elsewhere fall back to strcmp before being rejected.
+ */
+enum nk_love_enum_kind {
+	NK_LOVE_ENUM_WINDOW_FLAG,
+	NK_LOVE_ENUM_SYMBOL,
+	NK_LOVE_ENUM_ALIGN,
+	NK_LOVE_ENUM_BUTTON,
+	NK_LOVE_ENUM_FORMAT,
+	NK_LOVE_ENUM_TREE,
+	NK_LOVE_ENUM_STATE,
+	NK_LOVE_ENUM_BEHAVIOR,
+	NK_LOVE_ENUM_COLOR_FORMAT,
+	NK_LOVE_ENUM_EDIT_TYPE,
+	NK_LOVE_ENUM_POPUP,
+	NK_LOVE_ENUM_CHART,
+	NK_LOVE_ENUM_DRAW,
+	NK_LOVE_ENUM_RENDER_MODE
+};
+
+static const char *nk_love_enum_kinds[] = {
+	"window flag",
+	"symbol type",
+	"alignment",
+	"mouse button",
+	"layout format",
+	"tree type",
+	"tree state",
+	"button behavior",
+	"color format",
+	"edit type",
+	"popup type",
+	"chart type",
+	"draw mode",
+	"render mode"
+};
+
+static const struct nk_love_enum_name {
+	enum nk_love_enum_kind kind;
+	const char *name;
+	nk_flags value;
+} nk_love_enum_names[] = {
+	{NK_LOVE_ENUM_WINDOW_FLAG, "border", NK_WINDOW_BORDER},
+	{NK_LOVE_ENUM_WINDOW_FLAG, "movable", NK_WINDOW_MOVABLE},
+	{NK_LOVE_ENUM_WINDOW_FLAG, "scalable", NK_WINDOW_SCALABLE},
+	{NK_LOVE_ENUM_WINDOW_FLAG, "closable", NK_WINDOW_CLOSABLE},
+	{NK_LOVE_ENUM_WINDOW_FLAG, "minimizable", NK_WINDOW_MINIMIZABLE},
+	{NK_LOVE_ENUM_WINDOW_FLAG, "scrollbar", NK_WINDOW_NO_SCROLLBAR},
+	{NK_LOVE_ENUM_WINDOW_FLAG, "title", NK_WINDOW_TITLE},
+	{NK_LOVE_ENUM_WINDOW_FLAG, "scroll auto hide", NK_WINDOW_SCROLL_AUTO_HIDE},
+	{NK_LOVE_ENUM_WINDOW_FLAG, "background", NK_WINDOW_BACKGROUND},
+	{NK_LOVE_ENUM_SYMBOL, "none", NK_SYMBOL_NONE},
+	{NK_LOVE_ENUM_SYMBOL, "x", NK_SYMBOL_X},
+	{NK_LOVE_ENUM_SYMBOL, "underscore", NK_SYMBOL_UNDERSCORE},
+	{NK_LOVE_ENUM_SYMBOL, "circle solid", NK_SYMBOL_CIRCLE_SOLID},
+	{NK_LOVE_ENUM_SYMBOL, "circle outline", NK_SYMBOL_CIRCLE_OUTLINE},
+	{NK_LOVE_ENUM_SYMBOL, "rect solid", NK_SYMBOL_RECT_SOLID},
+	{NK_LOVE_ENUM_SYMBOL, "rect outline", NK_SYMBOL_RECT_OUTLINE},
+	{NK_LOVE_ENUM_SYMBOL, "triangle up", NK_SYMBOL_TRIANGLE_UP},
+	{NK_LOVE_ENUM_SYMBOL, "triangle down", NK_SYMBOL_TRIANGLE_DOWN},
+	{NK_LOVE_ENUM_SYMBOL, "triangle left", NK_SYMBOL_TRIANGLE_LEFT},
+	{NK_LOVE_ENUM_SYMBOL, "triangle right", NK_SYMBOL_TRIANGLE_RIGHT},
+	{NK_LOVE_ENUM_SYMBOL, "plus", NK_SYMBOL_PLUS},
+	{NK_LOVE_ENUM_SYMBOL, "minus", NK_SYMBOL_MINUS},
+	{NK_LOVE_ENUM_SYMBOL, "max", NK_SYMBOL_MAX},
+	{NK_LOVE_ENUM_ALIGN, "left", NK_TEXT_LEFT},
+	{NK_LOVE_ENUM_ALIGN, "centered", NK_TEXT_CENTERED},
+	{NK_LOVE_ENUM_ALIGN, "right", NK_TEXT_RIGHT},
+	{NK_LOVE_ENUM_ALIGN, "top left", NK_TEXT_ALIGN_TOP | NK_TEXT_ALIGN_LEFT},
+	{NK_LOVE_ENUM_ALIGN, "top centered", NK_TEXT_ALIGN_TOP | NK_TEXT_ALIGN_CENTERED},
+	{NK_LOVE_ENUM_ALIGN, "top right", NK_TEXT_ALIGN_TOP | NK_TEXT_ALIGN_RIGHT},
+	{NK_LOVE_ENUM_ALIGN, "bottom left", NK_TEXT_ALIGN_BOTTOM | NK_TEXT_ALIGN_LEFT},
+	{NK_LOVE_ENUM_ALIGN, "bottom centered", NK_TEXT_ALIGN_BOTTOM | NK_TEXT_ALIGN_CENTERED},
+	{NK_LOVE_ENUM_ALIGN, "bottom right", NK_TEXT_ALIGN_BOTTOM | NK_TEXT_ALIGN_RIGHT},
+	{NK_LOVE_ENUM_BUTTON, "left", NK_BUTTON_LEFT},
+	{NK_LOVE_ENUM_BUTTON, "right", NK_BUTTON_RIGHT},
+	{NK_LOVE_ENUM_BUTTON, "middle", NK_BUTTON_MIDDLE},
+	{NK_LOVE_ENUM_FORMAT, "dynamic", NK_DYNAMIC},
+	{NK_LOVE_ENUM_FORMAT, "static", NK_STATIC},
+	{NK_LOVE_ENUM_TREE, "node", NK_TREE_NODE},
+	{NK_LOVE_ENUM_TREE, "tab", NK_TREE_TAB},
+	{NK_LOVE_ENUM_STATE, "collapsed", NK_MINIMIZED},
+	{NK_LOVE_ENUM_STATE, "expanded", NK_MAXIMIZED},
+	{NK_LOVE_ENUM_BEHAVIOR, "default", NK_BUTTON_DEFAULT},
+	{NK_LOVE_ENUM_BEHAVIOR, "repeater", NK_BUTTON_REPEATER},
+	{NK_LOVE_ENUM_COLOR_FORMAT, "RGB", NK_RGB},
+	{NK_LOVE_ENUM_COLOR_FORMAT, "RGBA", NK_RGBA},
+	{NK_LOVE_ENUM_EDIT_TYPE, "simple", NK_EDIT_SIMPLE},
+	{NK_LOVE_ENUM_EDIT_TYPE, "field", NK_EDIT_FIELD},
+	{NK_LOVE_ENUM_EDIT_TYPE, "box", NK_EDIT_BOX},
+	{NK_LOVE_ENUM_POPUP, "dynamic", NK_POPUP_DYNAMIC},
+	{NK_LOVE_ENUM_POPUP, "static", NK_POPUP_STATIC},
+	{NK_LOVE_ENUM_CHART, "lines", NK_CHART_LINES},
+	{NK_LOVE_ENUM_CHART, "column", NK_CHART_COLUMN},
+	{NK_LOVE_ENUM_DRAW, "fill", NK_LOVE_FILL},
+	{NK_LOVE_ENUM_DRAW, "line", NK_LOVE_LINE},
+	{NK_LOVE_ENUM_RENDER_MODE, "immediate", NK_LOVE_RENDER_IMMEDIATE},
+	{NK_LOVE_ENUM_RENDER_MODE, "batched", NK_LOVE_RENDER_BATCHED}
+};
+
+#define NK_LOVE_ENUM_NAME_COUNT (sizeof(nk_love_enum_names) / sizeof(nk_love_enum_names[0]))
+
+static struct nk_love_enum_slot {
+	const char *name;
+	const struct nk_love_enum_name *entry;
+} enum_slots[NK_LOVE_ENUM_SLOTS];
+
+static size_t nk_love_enum_slot(const char *name, enum nk_love_enum_kind kind)
+{
+	size_t h = (size_t) name;
+	h = (h >> 3) ^ (h >> 11) ^ ((size_t) kind * 0x9e3779b1u);
+	return h & (NK_LOVE_ENUM_SLOTS - 1);
+}
+
+static void nk_love_intern_enums(lua_State *L)
+{
+	/* Expects the module registry table on top of the stack. */
+	memset(enum_slots, 0, sizeof(enum_slots));
+	lua_createtable(L, NK_LOVE_ENUM_NAME_COUNT, 0);
+	size_t i;
+	for (i = 0; i < NK_LOVE_ENUM_NAME_COUNT; ++i) {
+		const struct nk_love_enum_name *entry = &nk_love_enum_names[i];
+		lua_pushstring(L, entry->name);
+		const char *name = lua_tostring(L, -1);
+		lua_rawseti(L, -2, i + 1);
+		size_t slot = nk_love_enum_slot(name, entry->kind);
+		while (enum_slots[slot].name)
+			slot = (slot + 1) & (NK_LOVE_ENUM_SLOTS - 1);
+		enum_slots[slot].name = name;
+		enum_slots[slot].entry = entry;
+	}
+	lua_setfield(L, -2, "enums");
+}
+
+static int nk_love_lookup_enum(const char *name, enum nk_love_enum_kind kind, nk_flags *value)
+{
+	size_t slot = nk_love_enum_slot(name, kind);
+	while (enum_slots[slot].name) {
+		const struct nk_love_enum_name *entry = enum_slots[slot].entry;
+		if (enum_slots[slot].name == name && entry->kind == kind) {
+			*value = entry->value;
+			return 1;
+		}
+		slot = (slot + 1) & (NK_LOVE_ENUM_SLOTS - 1);
+	}
+	size_t i;
+	for (i = 0; i < NK_LOVE_ENUM_NAME_COUNT; ++i) {
+		const struct nk_love_enum_name *entry = &nk_love_enum_names[i];
+		if (entry->kind == kind && !strcmp(entry->name, name)) {
+			*value = entry->value;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static nk_flags nk_love_checkenum(lua_State *L, int index, enum nk_love_enum_kind kind)
+{
+	if (index < 0)
+		index += lua_gettop(L) + 1;
+	const char *name = luaL_checkstring(L, index);
+	nk_flags value;
+	if (!nk_love_lookup_enum(name, kind, &value)) {
+		const char *msg = lua_pushfstring(L, "unrecognized %s '%s'", nk_love_enum_kinds[kind], name);
+		return luaL_argerror(L, index, msg);
+	}
+	return value;
+}
+
+/* "scrollbar" clears the default NK_WINDOW_NO_SCROLLBAR; other flags are set. */
+static nk_flags nk_love_add_window_flag(nk_flags flags, nk_flags flag)
+{
+	if (flag == NK_WINDOW_NO_SCROLLBAR)
+		return flags & ~NK_WINDOW_NO_SCROLLBAR;
+	return flags | flag;
+}
+
 static nk_flags nk_love_parse_window_flags(lua_State *L, int flags_begin, int flags_end)
 {
 	int i;
+	nk_flags flags = NK_WINDOW_NO_SCROLLBAR;
+	if (flags_begin == flags_end && lua_type(L, flags_begin) == LUA_TNUMBER)
+		return (nk_flags) lua_tonumber(L, flags_begin);
 	if (flags_begin == flags_end && lua_istable(L, flags_begin)) {
-		size_t flagCount = lua_objlen(L, flags_begin);
-		nk_love_assert(L, lua_checkstack(L, flagCount), "%s: failed to allocate stack space");
+		/* Flags in a table are read in place, so the caller's stack
+		 * indices stay valid. */
+		int flagCount = (int) lua_objlen(L, flags_begin);
 		for (i = 1; i <= flagCount; ++i) {
 			lua_rawgeti(L, flags_begin, i);
+			const char *name = lua_tostring(L, -1);
+			nk_flags flag;
+			if (name == NULL || !nk_love_lookup_enum(name, NK_LOVE_ENUM_WINDOW_FLAG, &flag)) {
+				const char *msg = lua_pushfstring(L, "unrecognized %s '%s'",
+					nk_love_enum_kinds[NK_LOVE_ENUM_WINDOW_FLAG], name ? name : luaL_typename(L, -1));
+				return luaL_argerror(L, flags_begin, msg);
+			}
+			flags = nk_love_add_window_flag(flags, flag);
+			lua_pop(L, 1);
 		}
-		lua_remove(L, flags_begin);
-		flags_end = flags_begin + flagCount - 1;
-	}
-	nk_flags flags = NK_WINDOW_NO_SCROLLBAR;
-	for (i = flags_begin; i <= flags_end; ++i) {
-		const char *flag = luaL_checkstring(L, i);
-		if (!strcmp(flag, "border"))
-			flags |= NK_WINDOW_BORDER;
-		else if (!strcmp(flag, "movable"))
-			flags |= NK_WINDOW_MOVABLE;
-		else if (!strcmp(flag, "scalable"))
-			flags |= NK_WINDOW_SCALABLE;
-		else if (!strcmp(flag, "closable"))
-			flags |= NK_WINDOW_CLOSABLE;
-		else if (!strcmp(flag, "minimizable"))
-			flags |= NK_WINDOW_MINIMIZABLE;
-		else if (!strcmp(flag, "scrollbar"))
-			flags &= ~NK_WINDOW_NO_SCROLLBAR;
-		else if (!strcmp(flag, "title"))
-			flags |= NK_WINDOW_TITLE;
-		else if (!strcmp(flag, "scroll auto hide"))
-			flags |= NK_WINDOW_SCROLL_AUTO_HIDE;
-		else if (!strcmp(flag, "background"))
-			flags |= NK_WINDOW_BACKGROUND;
-		else {
-			const char *msg = lua_pushfstring(L, "unrecognized window flag '%s'", flag);
-			return luaL_argerror(L, i, msg);
-		}
+		return flags;
 	}
+	for (i = flags_begin; i <= flags_end; ++i)
+		flags = nk_love_add_window_flag(flags, nk_love_checkenum(L, i, NK_LOVE_ENUM_WINDOW_FLAG));
 	return flags;
 }
 
 static enum nk_symbol_type nk_love_checksymbol(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *s = luaL_checkstring(L, index);
-	if (!strcmp(s, "none")) {
-		return NK_SYMBOL_NONE;
-	} else if (!strcmp(s, "x")) {
-		return NK_SYMBOL_X;
-	} else if (!strcmp(s, "underscore")) {
-		return NK_SYMBOL_UNDERSCORE;
-	} else if (!strcmp(s, "circle solid")) {
-		return NK_SYMBOL_CIRCLE_SOLID;
-	} else if (!strcmp(s, "circle outline")) {
-		return NK_SYMBOL_CIRCLE_OUTLINE;
-	} else if (!strcmp(s, "rect solid")) {
-		return NK_SYMBOL_RECT_SOLID;
-	} else if (!strcmp(s, "rect outline")) {
-		return NK_SYMBOL_RECT_OUTLINE;
-	} else if (!strcmp(s, "triangle up")) {
-		return NK_SYMBOL_TRIANGLE_UP;
-	} else if (!strcmp(s, "triangle down")) {
-		return NK_SYMBOL_TRIANGLE_DOWN;
-	} else if (!strcmp(s, "triangle left")) {
-		return NK_SYMBOL_TRIANGLE_LEFT;
-	} else if (!strcmp(s, "triangle right")) {
-		return NK_SYMBOL_TRIANGLE_RIGHT;
-	} else if (!strcmp(s, "plus")) {
-		return NK_SYMBOL_PLUS;
-	} else if (!strcmp(s, "minus")) {
-		return NK_SYMBOL_MINUS;
-	} else if (!strcmp(s, "max")) {
-		return NK_SYMBOL_MAX;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized symbol type '%s'", s);
-		return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_symbol_type) nk_love_checkenum(L, index, NK_LOVE_ENUM_SYMBOL);
 }
 
 static nk_flags nk_love_checkalign(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *s = luaL_checkstring(L, index);
-	if (!strcmp(s, "left")) {
-		return NK_TEXT_LEFT;
-	} else if (!strcmp(s, "centered")) {
-		return NK_TEXT_CENTERED;
-	} else if (!strcmp(s, "right")) {
-		return NK_TEXT_RIGHT;
-	} else if (!strcmp(s, "top left")) {
-		return NK_TEXT_ALIGN_TOP | NK_TEXT_ALIGN_LEFT;
-	} else if (!strcmp(s, "top centered")) {
-		return NK_TEXT_ALIGN_TOP | NK_TEXT_ALIGN_CENTERED;
-	} else if (!strcmp(s, "top right")) {
-		return NK_TEXT_ALIGN_TOP | NK_TEXT_ALIGN_RIGHT;
-	} else if (!strcmp(s, "bottom left")) {
-		return NK_TEXT_ALIGN_BOTTOM | NK_TEXT_ALIGN_LEFT;
-	} else if (!strcmp(s, "bottom centered")) {
-		return NK_TEXT_ALIGN_BOTTOM | NK_TEXT_ALIGN_CENTERED;
-	} else if (!strcmp(s, "bottom right")) {
-		return NK_TEXT_ALIGN_BOTTOM | NK_TEXT_ALIGN_RIGHT;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized alignment '%s'", s);
-		return luaL_argerror(L, index, msg);
-	}
+	return nk_love_checkenum(L, index, NK_LOVE_ENUM_ALIGN);
 }
 
 static enum nk_buttons nk_love_checkbutton(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *s = luaL_checkstring(L, index);
-	if (!strcmp(s, "left")) {
-		return NK_BUTTON_LEFT;
-	} else if (!strcmp(s, "right")) {
-		return NK_BUTTON_RIGHT;
-	} else if (!strcmp(s, "middle")) {
-		return NK_BUTTON_MIDDLE;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized mouse button '%s'", s);
-		return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_buttons) nk_love_checkenum(L, index, NK_LOVE_ENUM_BUTTON);
 }
 
 static enum nk_layout_format nk_love_checkformat(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *type = luaL_checkstring(L, index);
-	if (!strcmp(type, "dynamic")) {
-		return NK_DYNAMIC;
-	} else if (!strcmp(type, "static")) {
-		return NK_STATIC;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized layout format '%s'", type);
-		return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_layout_format) nk_love_checkenum(L, index, NK_LOVE_ENUM_FORMAT);
 }
 
 static enum nk_tree_type nk_love_checktree(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *type_string = luaL_checkstring(L, index);
-	if (!strcmp(type_string, "node")) {
-		return NK_TREE_NODE;
-	} else if (!strcmp(type_string, "tab")) {
-		return NK_TREE_TAB;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized tree type '%s'", type_string);
-		return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_tree_type) nk_love_checkenum(L, index, NK_LOVE_ENUM_TREE);
 }
 
 static enum nk_collapse_states nk_love_checkstate(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *state_string = luaL_checkstring(L, index);
-	if (!strcmp(state_string, "collapsed")) {
-		return NK_MINIMIZED;
-	} else if (!strcmp(state_string, "expanded")) {
-		return NK_MAXIMIZED;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized tree state '%s'", state_string);
-		return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_collapse_states) nk_love_checkenum(L, index, NK_LOVE_ENUM_STATE);
 }
 
 static enum nk_button_behavior nk_love_checkbehavior(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *behavior_string = luaL_checkstring(L, index);
-	if (!strcmp(behavior_string, "default"))
-		return NK_BUTTON_DEFAULT;
-	else if (!strcmp(behavior_string, "repeater"))
-		return NK_BUTTON_REPEATER;
-	else {
-		const char *msg = lua_pushfstring(L, "unrecognized button behavior '%s'", behavior_string);
-		return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_button_behavior) nk_love_checkenum(L, index, NK_LOVE_ENUM_BEHAVIOR);
 }
 
 static enum nk_color_format nk_love_checkcolorformat(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *format_string = luaL_checkstring(L, index);
-	if (!strcmp(format_string, "RGB")) {
-		return NK_RGB;
-	} else if (!strcmp(format_string, "RGBA")) {
-	 	return NK_RGBA;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized color format '%s'", format_string);
-		return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_color_format) nk_love_checkenum(L, index, NK_LOVE_ENUM_COLOR_FORMAT);
 }
 
 static nk_flags nk_love_checkedittype(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *type_string = luaL_checkstring(L, index);
-	if (!strcmp(type_string, "simple")) {
-		return NK_EDIT_SIMPLE;
-	} else if (!strcmp(type_string, "field")) {
-		return NK_EDIT_FIELD;
-	} else if (!strcmp(type_string, "box")) {
-		return NK_EDIT_BOX;
-	} else {
-	 	const char *msg = lua_pushfstring(L, "unrecognized edit type '%s'", type_string);
-	 	return luaL_argerror(L, index, msg);
- }
+	return nk_love_checkenum(L, index, NK_LOVE_ENUM_EDIT_TYPE);
 }
 
 static enum nk_popup_type nk_love_checkpopup(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *popup_type = luaL_checkstring(L, index);
-	if (!strcmp(popup_type, "dynamic")) {
-		return NK_POPUP_DYNAMIC;
-	} else if (!strcmp(popup_type, "static")) {
-		return NK_POPUP_STATIC;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized popup type '%s'", popup_type);
-	 	return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_popup_type) nk_love_checkenum(L, index, NK_LOVE_ENUM_POPUP);
 }
 
-enum nk_love_draw_mode {NK_LOVE_FILL, NK_LOVE_LINE};
+static enum nk_chart_type nk_love_checkcharttype(lua_State *L, int index)
+{
+	return (enum nk_chart_type) nk_love_checkenum(L, index, NK_LOVE_ENUM_CHART);
+}
 
 static enum nk_love_draw_mode nk_love_checkdraw(lua_State *L, int index)
 {
-	if (index < 0)
-		index += lua_gettop(L) + 1;
-	const char *mode = luaL_checkstring(L, index);
-	if (!strcmp(mode, "fill")) {
-		return NK_LOVE_FILL;
-	} else if (!strcmp(mode, "line")) {
-		return NK_LOVE_LINE;
-	} else {
-		const char *msg = lua_pushfstring(L, "unrecognized draw mode '%s'", mode);
-	 	return luaL_argerror(L, index, msg);
-	}
+	return (enum nk_love_draw_mode) nk_love_checkenum(L, index, NK_LOVE_ENUM_DRAW);
+}
+
+static enum nk_love_render_mode nk_love_checkrendermode(lua_State *L, int index)
+{
+	return (enum nk_love_render_mode) nk_love_checkenum(L, index, NK_LOVE_ENUM_RENDER_MODE);
 }
 
 static int nk_love_checkboolean(lua_State *L, int index)
@@ -579,17 +1409,105 @@ static void nk_love_transform(float *T, int *x, int *y)
  * ===============================================================
  */
 
-static void nk_love_configureGraphics(lua_State *L, int line_thickness, struct nk_color col)
+static void nk_love_resolve_graphics(lua_State *L)
 {
+	if (graphics_resolved)
+		return;
 	lua_getglobal(L, "love");
 	lua_getfield(L, -1, "graphics");
-	lua_remove(L, -2);
-	if (line_thickness >= 0) {
-		lua_getfield(L, -1, "setLineWidth");
-		lua_pushnumber(L, line_thickness);
-		lua_call(L, 1, 0);
+	int i;
+	for (i = 0; i < NK_LOVE_GRAPHICS_FUNCTION_COUNT; ++i) {
+		lua_getfield(L, -1, nk_love_graphics_names[i]);
+		graphics_refs[i] = luaL_ref(L, LUA_REGISTRYINDEX);
+	}
+	lua_pop(L, 2);
+	graphics_resolved = 1;
+}
+
+static void nk_love_invalidate_graphics(lua_State *L)
+{
+	if (!graphics_resolved)
+		return;
+	int i;
+	for (i = 0; i < NK_LOVE_GRAPHICS_FUNCTION_COUNT; ++i)
+		luaL_unref(L, LUA_REGISTRYINDEX, graphics_refs[i]);
+	graphics_resolved = 0;
+}
+
+static void nk_love_pushgraphics(lua_State *L, enum nk_love_graphics_function f)
+{
+	lua_rawgeti(L, LUA_REGISTRYINDEX, graphics_refs[f]);
+}
+
+static unsigned int nk_love_arc_segments(float r, float angle)
+{
+	const float *T = context->T;
+	float error = context->tessellation_error;
+	r *= sqrtf(fabsf(T[0] * T[4] - T[1] * T[3]));
+	angle = fabsf(angle);
+	unsigned int min = (unsigned int) ceilf(NK_LOVE_MIN_SEGMENTS * angle / (2 * NK_PI));
+	min = NK_MAX(min, 1);
+	if (r <= error)
+		return min;
+	unsigned int segments = (unsigned int) ceilf(angle / (2 * acosf(1 - error / r)));
+	return NK_CLAMP(min, segments, NK_LOVE_MAX_SEGMENTS);
+}
+
+static unsigned int nk_love_curve_segments(struct nk_vec2i p0, struct nk_vec2i p1,
+	struct nk_vec2i p2, struct nk_vec2i p3)
+{
+	const float *T = context->T;
+	float d[4] = {
+		p0.x - 2 * p1.x + p2.x, p0.y - 2 * p1.y + p2.y,
+		p1.x - 2 * p2.x + p3.x, p1.y - 2 * p2.y + p3.y
+	};
+	float m = 0;
+	int i;
+	for (i = 0; i < 4; i += 2) {
+		float x = d[i] * T[0] + d[i + 1] * T[3];
+		float y = d[i] * T[1] + d[i + 1] * T[4];
+		m = NK_MAX(m, sqrtf(x * x + y * y));
+	}
+	unsigned int segments = (unsigned int) ceilf(sqrtf(0.75f * m / context->tessellation_error));
+	return NK_CLAMP(1, segments, NK_LOVE_MAX_SEGMENTS);
+}
+
+static const float *nk_love_unit_circle(lua_State *L, unsigned int *segments)
+{
+	unsigned int index = (*segments + 3) / 4;
+	*segments = index * 4;
+	if (unit_circles[index] == NULL) {
+		float *circle = nk_love_malloc(L, sizeof(float) * 2 * *segments);
+		unsigned int i;
+		for (i = 0; i < *segments; ++i) {
+			float a = 2 * NK_PI * i / *segments;
+			circle[i * 2] = cosf(a);
+			circle[i * 2 + 1] = sinf(a);
+		}
+		unit_circles[index] = circle;
 	}
-	lua_getfield(L, -1, "setColor");
+	return unit_circles[index];
+}
+
+static int nk_love_state_changed(int changed)
+{
+	if (changed)
+		context->stats.state_changes++;
+	else
+		context->stats.state_changes_skipped++;
+	return changed;
+}
+
+static void nk_love_set_color(lua_State *L, struct nk_color col)
+{
+	struct nk_love_graphics_state *state = &context->state;
+	if (!nk_love_state_changed(!state->has_color || state->color.r != col.r
+			|| state->color.g != col.g || state->color.b != col.b
+			|| state->color.a != col.a))
+		return;
+	state->has_color = 1;
+	state->color = col;
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_SET_COLOR);
 	lua_pushnumber(L, col.r / 255.0);
 	lua_pushnumber(L, col.g / 255.0);
 	lua_pushnumber(L, col.b / 255.0);
@@ -597,29 +1515,73 @@ static void nk_love_configureGraphics(lua_State *L, int line_thickness, struct n
 	lua_call(L, 4, 0);
 }
 
-static void nk_love_getGraphics(lua_State *L, float *line_thickness, struct nk_color *color)
+static void nk_love_set_line_width(lua_State *L, int line_width)
+{
+	struct nk_love_graphics_state *state = &context->state;
+	if (!nk_love_state_changed(!state->has_line_width || state->line_width != line_width))
+		return;
+	state->has_line_width = 1;
+	state->line_width = line_width;
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_SET_LINE_WIDTH);
+	lua_pushnumber(L, line_width);
+	lua_call(L, 1, 0);
+}
+
+static void nk_love_set_font(lua_State *L, int fontref)
+{
+	struct nk_love_graphics_state *state = &context->state;
+	if (!nk_love_state_changed(!state->has_font || state->font_ref != fontref))
+		return;
+	state->has_font = 1;
+	state->font_ref = fontref;
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_SET_FONT);
+	nk_love_pushregistry(L, "font");
+	lua_rawgeti(L, -1, fontref);
+	lua_replace(L, -2);
+	lua_call(L, 1, 0);
+}
+
+static void nk_love_configureGraphics(lua_State *L, int line_thickness, struct nk_color col)
+{
+	if (line_thickness >= 0)
+		nk_love_set_line_width(L, line_thickness);
+	nk_love_set_color(L, col);
+}
+
+static void nk_love_getPen(float *line_thickness, struct nk_color *color)
+{
+	*line_thickness = context->pen.line_width;
+	*color = context->pen.color;
+}
+
+/*
+ * In pen sync mode the pen and the text font are copied from love.graphics
+ * once per frame, for code written against the old per-call queries.
+ */
+static void nk_love_sync_pen(lua_State *L)
 {
 	lua_getglobal(L, "love");
 	lua_getfield(L, -1, "graphics");
 	lua_getfield(L, -1, "getLineWidth");
 	lua_call(L, 0, 1);
-	*line_thickness = lua_tonumber(L, -1);
+	context->pen.line_width = lua_tonumber(L, -1);
 	lua_pop(L, 1);
 	lua_getfield(L, -1, "getColor");
 	lua_call(L, 0, 4);
-	color->r = (int) (lua_tonumber(L, -4) * 255.0);
-	color->g = (int) (lua_tonumber(L, -3) * 255.0);
-	color->b = (int) (lua_tonumber(L, -2) * 255.0);
-	color->a = (int) (lua_tonumber(L, -1) * 255.0);
-	lua_pop(L, 6);
+	context->pen.color.r = (int) (lua_tonumber(L, -4) * 255.0);
+	context->pen.color.g = (int) (lua_tonumber(L, -3) * 255.0);
+	context->pen.color.b = (int) (lua_tonumber(L, -2) * 255.0);
+	context->pen.color.a = (int) (lua_tonumber(L, -1) * 255.0);
+	lua_pop(L, 4);
+	lua_getfield(L, -1, "getFont");
+	lua_call(L, 0, 1);
+	context->pen_font = &nk_love_checkFont(L, -1)->font;
+	lua_pop(L, 3);
 }
 
 static void nk_love_scissor(lua_State *L, int x, int y, int w, int h,
 		int nested, int px, int py, int pw, int ph)
 {
-	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "graphics");
-	lua_getfield(L, -1, "setScissor");
 	int x1 = x, y1 = y, x2 = x + w, y2 = y, x3 = x, y3 = y + h, x4 = x + w, y4 = y + h;
 	nk_love_transform(context->T, &x1, &y1);
 	nk_love_transform(context->T, &x2, &y2);
@@ -635,25 +1597,35 @@ static void nk_love_scissor(lua_State *L, int x, int y, int w, int h,
 		right = NK_MIN(right, px + pw);
 		bottom = NK_MIN(bottom, py + ph);
 	}
+	int width = NK_MAX(0, right - left), height = NK_MAX(0, bottom - top);
+	struct nk_love_graphics_state *state = &context->state;
+	if (!nk_love_state_changed(!state->has_scissor || state->scissor[0] != left
+			|| state->scissor[1] != top || state->scissor[2] != width
+			|| state->scissor[3] != height))
+		return;
+	state->has_scissor = 1;
+	state->scissor[0] = left;
+	state->scissor[1] = top;
+	state->scissor[2] = width;
+	state->scissor[3] = height;
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_SET_SCISSOR);
 	lua_pushnumber(L, left);
 	lua_pushnumber(L, top);
-	lua_pushnumber(L, NK_MAX(0, right - left));
-	lua_pushnumber(L, NK_MAX(0, bottom - top));
+	lua_pushnumber(L, width);
+	lua_pushnumber(L, height);
 	lua_call(L, 4, 0);
-	lua_pop(L, 2);
 }
 
 static void nk_love_draw_line(lua_State *L, int x0, int y0, int x1, int y1,
 	int line_thickness, struct nk_color col)
 {
 	nk_love_configureGraphics(L, line_thickness, col);
-	lua_getfield(L, -1, "line");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_LINE);
 	lua_pushnumber(L, x0 + 0.5);
 	lua_pushnumber(L, y0 + 0.5);
 	lua_pushnumber(L, x1 + 0.5);
 	lua_pushnumber(L, y1 + 0.5);
 	lua_call(L, 4, 0);
-	lua_pop(L, 1);
 }
 
 static void nk_love_draw_rect(lua_State *L, int x, int y, unsigned int w,
@@ -661,7 +1633,7 @@ static void nk_love_draw_rect(lua_State *L, int x, int y, unsigned int w,
 	struct nk_color col)
 {
 	nk_love_configureGraphics(L, line_thickness, col);
-	lua_getfield(L, -1, "rectangle");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_RECTANGLE);
 	if (line_thickness >= 0)
 		lua_pushstring(L, "line");
 	else
@@ -673,14 +1645,13 @@ static void nk_love_draw_rect(lua_State *L, int x, int y, unsigned int w,
 	lua_pushnumber(L, r);
 	lua_pushnumber(L, r);
 	lua_call(L, 7, 0);
-	lua_pop(L, 1);
 }
 
 static void nk_love_draw_triangle(lua_State *L, int x0, int y0, int x1, int y1,
 	int x2, int y2,	int line_thickness, struct nk_color col)
 {
 	nk_love_configureGraphics(L, line_thickness, col);
-	lua_getfield(L, -1, "polygon");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_POLYGON);
 	if (line_thickness >= 0)
 		lua_pushstring(L, "line");
 	else
@@ -692,46 +1663,45 @@ static void nk_love_draw_triangle(lua_State *L, int x0, int y0, int x1, int y1,
 	lua_pushnumber(L, x2 + 0.5);
 	lua_pushnumber(L, y2 + 0.5);
 	lua_call(L, 7, 0);
-	lua_pop(L, 1);
 }
 
 static void nk_love_draw_polygon(lua_State *L, const struct nk_vec2i *pnts, int count,
 	int line_thickness, struct nk_color col)
 {
 	nk_love_configureGraphics(L, line_thickness, col);
-	lua_getfield(L, -1, "polygon");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_POLYGON);
 	if (line_thickness >= 0)
 		lua_pushstring(L, "line");
 	else
 		lua_pushstring(L, "fill");
+	nk_love_assert(L, lua_checkstack(L, count * 2), "%s: failed to allocate stack space");
 	int i;
-	for (i = 0; (i < count) && (i < NK_LOVE_MAX_POINTS); ++i) {
+	for (i = 0; i < count; ++i) {
 		lua_pushnumber(L, pnts[i].x + 0.5);
 		lua_pushnumber(L, pnts[i].y + 0.5);
 	}
 	lua_call(L, 1 + count * 2, 0);
-	lua_pop(L, 1);
 }
 
 static void nk_love_draw_polyline(lua_State *L, const struct nk_vec2i *pnts,
 	int count, int line_thickness, struct nk_color col)
 {
 	nk_love_configureGraphics(L, line_thickness, col);
-	lua_getfield(L, -1, "line");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_LINE);
+	nk_love_assert(L, lua_checkstack(L, count * 2), "%s: failed to allocate stack space");
 	int i;
-	for (i = 0; (i < count) && (i < NK_LOVE_MAX_POINTS); ++i) {
+	for (i = 0; i < count; ++i) {
 		lua_pushnumber(L, pnts[i].x + 0.5);
 		lua_pushnumber(L, pnts[i].y + 0.5);
 	}
 	lua_call(L, count * 2, 0);
-	lua_pop(L, 1);
 }
 
 static void nk_love_draw_circle(lua_State *L, int x, int y, unsigned int w,
 	unsigned int h, int line_thickness, struct nk_color col)
 {
 	nk_love_configureGraphics(L, line_thickness, col);
-	lua_getfield(L, -1, "ellipse");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_ELLIPSE);
 	if (line_thickness >= 0)
 		lua_pushstring(L, "line");
 	else
@@ -740,23 +1710,22 @@ static void nk_love_draw_circle(lua_State *L, int x, int y, unsigned int w,
 	lua_pushnumber(L, y + h / 2);
 	lua_pushnumber(L, w / 2);
 	lua_pushnumber(L, h / 2);
-	lua_call(L, 5, 0);
-	lua_pop(L, 1);
+	lua_pushnumber(L, nk_love_arc_segments(NK_MAX(w, h) / 2.0f, 2 * NK_PI));
+	lua_call(L, 6, 0);
 }
 
 static void nk_love_draw_curve(lua_State *L, struct nk_vec2i p1, struct nk_vec2i p2,
-	struct nk_vec2i p3, struct nk_vec2i p4, unsigned int num_segments,
-	int line_thickness, struct nk_color col)
+	struct nk_vec2i p3, struct nk_vec2i p4, int line_thickness, struct nk_color col)
 {
 	unsigned int i_step;
-	float t_step;
-	struct nk_vec2i last = p1;
+	unsigned int num_segments = nk_love_curve_segments(p1, p2, p3, p4);
+	float t_step = 1.0f/(float)num_segments;
 
-	if (num_segments < 1)
-		num_segments = 1;
-	t_step = 1.0f/(float)num_segments;
 	nk_love_configureGraphics(L, line_thickness, col);
-	lua_getfield(L, -1, "line");
+	luaL_checkstack(L, num_segments * 2 + 3, "too many curve segments");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_LINE);
+	lua_pushnumber(L, p1.x);
+	lua_pushnumber(L, p1.y);
 	for (i_step = 1; i_step <= num_segments; ++i_step) {
 		float t = t_step * (float)i_step;
 		float u = 1.0f - t;
@@ -769,25 +1738,16 @@ static void nk_love_draw_curve(lua_State *L, struct nk_vec2i p1, struct nk_vec2i
 		lua_pushnumber(L, x);
 		lua_pushnumber(L, y);
 	}
-	lua_call(L, num_segments * 2, 0);
-	lua_pop(L, 1);
+	lua_call(L, num_segments * 2 + 2, 0);
 }
 
 static void nk_love_draw_text(lua_State *L, int fontref, struct nk_color cbg,
 	struct nk_color cfg, int x, int y, unsigned int w, unsigned int h,
 	float height, int len, const char *text)
 {
-	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "graphics");
+	nk_love_set_color(L, cbg);
 
-	lua_getfield(L, -1, "setColor");
-	lua_pushnumber(L, cbg.r / 255.0);
-	lua_pushnumber(L, cbg.g / 255.0);
-	lua_pushnumber(L, cbg.b / 255.0);
-	lua_pushnumber(L, cbg.a / 255.0);
-	lua_call(L, 4, 0);
-
-	lua_getfield(L, -1, "rectangle");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_RECTANGLE);
 	lua_pushstring(L, "fill");
 	lua_pushnumber(L, x);
 	lua_pushnumber(L, y);
@@ -795,95 +1755,59 @@ static void nk_love_draw_text(lua_State *L, int fontref, struct nk_color cbg,
 	lua_pushnumber(L, h);
 	lua_call(L, 5, 0);
 
-	lua_getfield(L, -1, "setColor");
-	lua_pushnumber(L, cfg.r / 255.0);
-	lua_pushnumber(L, cfg.g / 255.0);
-	lua_pushnumber(L, cfg.b / 255.0);
-	lua_pushnumber(L, cfg.a / 255.0);
-	lua_call(L, 4, 0);
-
-	lua_getfield(L, -1, "setFont");
-	nk_love_pushregistry(L, "font");
-	lua_rawgeti(L, -1, fontref);
-	lua_replace(L, -2);
-	lua_call(L, 1, 0);
+	nk_love_set_color(L, cfg);
+	nk_love_set_font(L, fontref);
 
-	lua_getfield(L, -1, "print");
-	lua_pushlstring(L, text, len);
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_PRINT);
+	nk_love_push_text(L, text, len);
 	lua_pushnumber(L, x);
 	lua_pushnumber(L, y);
 	lua_call(L, 3, 0);
-
-	lua_pop(L, 2);
 }
 
-static void interpolate_color(struct nk_color c1, struct nk_color c2,
-	struct nk_color *result, float fraction)
+static void nk_love_set_gradient_vertex(lua_State *L, int index, float x, float y,
+	struct nk_color col)
 {
-	float r = c1.r + (c2.r - c1.r) * fraction;
-	float g = c1.g + (c2.g - c1.g) * fraction;
-	float b = c1.b + (c2.b - c1.b) * fraction;
-	float a = c1.a + (c2.a - c1.a) * fraction;
-
-	result->r = (nk_byte)NK_CLAMP(0, r, 255);
-	result->g = (nk_byte)NK_CLAMP(0, g, 255);
-	result->b = (nk_byte)NK_CLAMP(0, b, 255);
-	result->a = (nk_byte)NK_CLAMP(0, a, 255);
+	lua_pushvalue(L, -1);
+	lua_pushvalue(L, -3);
+	lua_pushnumber(L, index);
+	lua_pushnumber(L, x);
+	lua_pushnumber(L, y);
+	lua_pushnumber(L, 0);
+	lua_pushnumber(L, 0);
+	lua_pushnumber(L, col.r / 255.0);
+	lua_pushnumber(L, col.g / 255.0);
+	lua_pushnumber(L, col.b / 255.0);
+	lua_pushnumber(L, col.a / 255.0);
+	lua_call(L, 9, 0);
 }
 
 static void nk_love_draw_rect_multi_color(lua_State *L, int x, int y, unsigned int w,
-	unsigned int h, struct nk_color left, struct nk_color top,
-	struct nk_color right, struct nk_color bottom)
+	unsigned int h, struct nk_color top_left, struct nk_color top_right,
+	struct nk_color bottom_right, struct nk_color bottom_left)
 {
-	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "graphics");
-
-	lua_getfield(L, -1, "push");
-	lua_pushstring(L, "all");
-	lua_call(L, 1, 0);
-	lua_getfield(L, -1, "setColor");
-	lua_pushnumber(L, 1.0);
-	lua_pushnumber(L, 1.0);
-	lua_pushnumber(L, 1.0);
-	lua_call(L, 3, 0);
-	lua_getfield(L, -1, "setPointSize");
-	lua_pushnumber(L, 1);
-	lua_call(L, 1, 0);
-
-	struct nk_color X1, X2, Y;
-	float fraction_x, fraction_y;
-	int i,j;
-
-	lua_getfield(L, -1, "points");
-	lua_createtable(L, w * h, 0);
-
-	for (j = 0; j < h; j++) {
-		fraction_y = ((float)j) / h;
-		for (i = 0; i < w; i++) {
-			fraction_x = ((float)i) / w;
-			interpolate_color(left, top, &X1, fraction_x);
-			interpolate_color(right, bottom, &X2, fraction_x);
-			interpolate_color(X1, X2, &Y, fraction_y);
-			lua_createtable(L, 6, 0);
-			lua_pushnumber(L, x + i);
-			lua_rawseti(L, -2, 1);
-			lua_pushnumber(L, y + j);
-			lua_rawseti(L, -2, 2);
-			lua_pushnumber(L, Y.r / 255.0);
-			lua_rawseti(L, -2, 3);
-			lua_pushnumber(L, Y.g / 255.0);
-			lua_rawseti(L, -2, 4);
-			lua_pushnumber(L, Y.b / 255.0);
-			lua_rawseti(L, -2, 5);
-			lua_pushnumber(L, Y.a / 255.0);
-			lua_rawseti(L, -2, 6);
-			lua_rawseti(L, -2, i + j * w + 1);
-		}
+	nk_love_pushregistry(L, "batch");
+	lua_getfield(L, -1, "gradient");
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_NEW_MESH);
+		lua_pushnumber(L, 4);
+		lua_pushstring(L, "fan");
+		lua_pushstring(L, "stream");
+		lua_call(L, 3, 1);
+		lua_pushvalue(L, -1);
+		lua_setfield(L, -3, "gradient");
 	}
-
+	lua_getfield(L, -1, "setVertex");
+	nk_love_set_gradient_vertex(L, 1, x, y, top_left);
+	nk_love_set_gradient_vertex(L, 2, x + w, y, top_right);
+	nk_love_set_gradient_vertex(L, 3, x + w, y + h, bottom_right);
+	nk_love_set_gradient_vertex(L, 4, x, y + h, bottom_left);
+	lua_pop(L, 1);
+	nk_love_set_color(L, nk_rgba(255, 255, 255, 255));
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_DRAW);
+	lua_pushvalue(L, -2);
 	lua_call(L, 1, 0);
-	lua_getfield(L, -1, "pop");
-	lua_call(L, 0, 0);
 	lua_pop(L, 2);
 }
 
@@ -891,7 +1815,7 @@ static void nk_love_draw_image(lua_State *L, int x, int y, unsigned int w, unsig
 	struct nk_image image, struct nk_color color)
 {
 	nk_love_configureGraphics(L, -1, color);
-	lua_getfield(L, -1, "draw");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_DRAW);
 	nk_love_pushregistry(L, "image");
 	lua_rawgeti(L, -1, image.handle.id);
 	lua_rawgeti(L, -1, 1);
@@ -901,23 +1825,16 @@ static void nk_love_draw_image(lua_State *L, int x, int y, unsigned int w, unsig
 	lua_pushnumber(L, x);
 	lua_pushnumber(L, y);
 	lua_pushnumber(L, 0);
-	lua_getfield(L, -4, "getViewport");
-	lua_pushvalue(L, -5);
-	lua_call(L, 1, 4);
-	double viewportWidth = lua_tonumber(L, -2);
-	double viewportHeight = lua_tonumber(L, -1);
-	lua_pop(L, 4);
-	lua_pushnumber(L, (double) w / viewportWidth);
-	lua_pushnumber(L, (double) h / viewportHeight);
+	lua_pushnumber(L, (double) w / image.region[2]);
+	lua_pushnumber(L, (double) h / image.region[3]);
 	lua_call(L, 7, 0);
-	lua_pop(L, 1);
 }
 
 static void nk_love_draw_arc(lua_State *L, int cx, int cy, unsigned int r,
 	int line_thickness, float a1, float a2, struct nk_color color)
 {
 	nk_love_configureGraphics(L, line_thickness, color);
-	lua_getfield(L, -1, "arc");
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_ARC);
 	if (line_thickness >= 0)
 		lua_pushstring(L, "line");
 	else
@@ -927,506 +1844,1235 @@ static void nk_love_draw_arc(lua_State *L, int cx, int cy, unsigned int r,
 	lua_pushnumber(L, r);
 	lua_pushnumber(L, a1);
 	lua_pushnumber(L, a2);
-	lua_call(L, 6, 0);
-	lua_pop(L, 1);
-}
-
-/*
- * ===============================================================
- *
- *                            INPUT
- *
- * ===============================================================
- */
-
-static void nk_love_clipboard_paste(nk_handle usr, struct nk_text_edit *edit)
-{
-	lua_State *L = usr.ptr;
-	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "system");
-	lua_getfield(L, -1, "getClipboardText");
-	lua_call(L, 0, 1);
-	const char *text = lua_tostring(L, -1);
-	if (text) nk_textedit_paste(edit, text, nk_strlen(text));
-	lua_pop(L, 3);
+	lua_pushnumber(L, nk_love_arc_segments(r, a2 - a1));
+	lua_call(L, 7, 0);
 }
 
-static void nk_love_clipboard_copy(nk_handle usr, const char *text, int len)
+static void nk_love_draw_immediate(lua_State *L, const struct nk_command *begin,
+	const struct nk_command *end, int nested, int px, int py, int pw, int ph)
 {
-	lua_State *L = usr.ptr;
-	char *str = 0;
-	if (!len) return;
-	str = (char*)malloc((size_t)len+1);
-	if (!str) return;
-	memcpy(str, text, (size_t)len);
-	str[len] = '\0';
-	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "system");
-	lua_getfield(L, -1, "setClipboardText");
-	lua_pushstring(L, str);
-	free(str);
-	lua_call(L, 1, 0);
-	lua_pop(L, 2);
+	const struct nk_command *cmd;
+	for (cmd = begin; cmd != end; cmd = nk__next(&context->nkctx, cmd))
+	{
+		switch (cmd->type) {
+		case NK_COMMAND_NOP: break;
+		case NK_COMMAND_SCISSOR: {
+			const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
+			nk_love_scissor(L, s->x, s->y, s->w, s->h, nested, px, py, pw, ph);
+		} break;
+		case NK_COMMAND_LINE: {
+			const struct nk_command_line *l = (const struct nk_command_line *)cmd;
+			nk_love_draw_line(L, l->begin.x, l->begin.y, l->end.x,
+				l->end.y, l->line_thickness, l->color);
+		} break;
+		case NK_COMMAND_RECT: {
+			const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
+			nk_love_draw_rect(L, r->x, r->y, r->w, r->h,
+				(unsigned int)r->rounding, r->line_thickness, r->color);
+		} break;
+		case NK_COMMAND_RECT_FILLED: {
+			const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
+			nk_love_draw_rect(L, r->x, r->y, r->w, r->h, (unsigned int)r->rounding, -1, r->color);
+		} break;
+		case NK_COMMAND_CIRCLE: {
+			const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
+			nk_love_draw_circle(L, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
+		} break;
+		case NK_COMMAND_CIRCLE_FILLED: {
+			const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
+			nk_love_draw_circle(L, c->x, c->y, c->w, c->h, -1, c->color);
+		} break;
+		case NK_COMMAND_TRIANGLE: {
+			const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
+			nk_love_draw_triangle(L, t->a.x, t->a.y, t->b.x, t->b.y,
+				t->c.x, t->c.y, t->line_thickness, t->color);
+		} break;
+		case NK_COMMAND_TRIANGLE_FILLED: {
+			const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
+			nk_love_draw_triangle(L, t->a.x, t->a.y, t->b.x, t->b.y, t->c.x, t->c.y, -1, t->color);
+		} break;
+		case NK_COMMAND_POLYGON: {
+			const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
+			nk_love_draw_polygon(L, p->points, p->point_count, p->line_thickness, p->color);
+		} break;
+		case NK_COMMAND_POLYGON_FILLED: {
+			const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
+			nk_love_draw_polygon(L, p->points, p->point_count, -1, p->color);
+		} break;
+		case NK_COMMAND_POLYLINE: {
+			const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
+			nk_love_draw_polyline(L, p->points, p->point_count, p->line_thickness, p->color);
+		} break;
+		case NK_COMMAND_TEXT: {
+			const struct nk_command_text *t = (const struct nk_command_text*)cmd;
+			struct nk_love_handle *love_handle = t->font->userdata.ptr;
+			nk_love_draw_text(love_handle->L, love_handle->ref, t->background,
+				t->foreground, t->x, t->y, t->w, t->h,
+				t->height, t->length, (const char*)t->string);
+		} break;
+		case NK_COMMAND_CURVE: {
+			const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
+			nk_love_draw_curve(L, q->begin, q->ctrl[0], q->ctrl[1],
+				q->end, q->line_thickness, q->color);
+		} break;
+		case NK_COMMAND_RECT_MULTI_COLOR: {
+			const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color *)cmd;
+			nk_love_draw_rect_multi_color(L, r->x, r->y, r->w, r->h,
+				r->left, r->top, r->right, r->bottom);
+		} break;
+		case NK_COMMAND_IMAGE: {
+			const struct nk_command_image *i = (const struct nk_command_image *)cmd;
+			nk_love_draw_image(L, i->x, i->y, i->w, i->h, i->img, i->col);
+		} break;
+		case NK_COMMAND_ARC: {
+			const struct nk_command_arc *a = (const struct nk_command_arc *)cmd;
+			nk_love_draw_arc(L, a->cx, a->cy, a->r, a->line_thickness,
+				a->a[0], a->a[1], a->color);
+		} break;
+		case NK_COMMAND_ARC_FILLED: {
+			const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled *)cmd;
+			nk_love_draw_arc(L, a->cx, a->cy, a->r, -1, a->a[0], a->a[1], a->color);
+		} break;
+		default: break;
+		}
+	}
 }
 
-static int nk_love_is_active(struct nk_context *ctx)
+static void nk_love_batch_init(struct nk_love_batch *batch)
 {
-	struct nk_window *iter;
-	iter = ctx->begin;
-	while (iter) {
-		/* check if window is being hovered */
-		if (iter->flags & NK_WINDOW_MINIMIZED) {
-			struct nk_rect header = iter->bounds;
-			header.h = ctx->style.font->height + 2 * ctx->style.window.header.padding.y;
-			if (nk_input_is_mouse_hovering_rect(&ctx->input, header))
-				return 1;
-		} else if (nk_input_is_mouse_hovering_rect(&ctx->input, iter->bounds)) {
-			return 1;
-		}
-		/* check if window popup is being hovered */
-		if (iter->popup.active && iter->popup.win && nk_input_is_mouse_hovering_rect(&ctx->input, iter->popup.win->bounds))
-			return 1;
-		if (iter->edit.active & NK_EDIT_ACTIVE)
-			return 1;
-		iter = iter->next;
+	memset(&batch->config, 0, sizeof(batch->config));
+	batch->config.vertex_layout = nk_love_vertex_layout;
+	batch->config.vertex_size = sizeof(struct nk_love_vertex);
+	batch->config.vertex_alignment = NK_ALIGNOF(struct nk_love_vertex);
+	batch->config.global_alpha = 1.0f;
+	batch->config.circle_segment_count = NK_LOVE_SEGMENT_COUNT;
+	batch->config.curve_segment_count = NK_LOVE_SEGMENT_COUNT;
+	batch->config.arc_segment_count = NK_LOVE_SEGMENT_COUNT;
+	batch->config.line_AA = NK_ANTI_ALIASING_ON;
+	batch->config.shape_AA = NK_ANTI_ALIASING_ON;
+	nk_buffer_init_default(&batch->cmds);
+	nk_buffer_init_default(&batch->vertices);
+	nk_buffer_init_default(&batch->elements);
+	nk_draw_list_init(&batch->list);
+	batch->vertex_capacity = 0;
+	batch->element_capacity = 0;
+}
+
+static void nk_love_batch_free(struct nk_love_batch *batch)
+{
+	nk_buffer_free(&batch->cmds);
+	nk_buffer_free(&batch->vertices);
+	nk_buffer_free(&batch->elements);
+}
+
+static void nk_love_batch_reset(struct nk_love_batch *batch)
+{
+	struct nk_rect clip = batch->list.clip_rect;
+	nk_buffer_clear(&batch->cmds);
+	nk_buffer_clear(&batch->vertices);
+	nk_buffer_clear(&batch->elements);
+	nk_draw_list_setup(&batch->list, &batch->config, &batch->cmds,
+		&batch->vertices, &batch->elements, batch->config.line_AA,
+		batch->config.shape_AA);
+	nk_draw_list_add_clip(&batch->list, clip);
+}
+
+static void nk_love_push_vertex_format(lua_State *L)
+{
+	static const char *names[] = {"VertexPosition", "VertexTexCoord", "VertexColor"};
+	static const char *types[] = {"float", "float", "byte"};
+	static const int components[] = {2, 2, 4};
+	int i;
+	lua_createtable(L, 3, 0);
+	for (i = 0; i < 3; ++i) {
+		lua_createtable(L, 3, 0);
+		lua_pushstring(L, names[i]);
+		lua_rawseti(L, -2, 1);
+		lua_pushstring(L, types[i]);
+		lua_rawseti(L, -2, 2);
+		lua_pushnumber(L, components[i]);
+		lua_rawseti(L, -2, 3);
+		lua_rawseti(L, -2, i + 1);
 	}
-	return 0;
 }
 
-static int nk_love_keyevent(lua_State *L, struct nk_context *ctx, const char *key,
-	const char *scancode, int isrepeat, int down)
+static void nk_love_push_byte_data(lua_State *L, size_t size)
 {
 	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "keyboard");
-	lua_getfield(L, -1, "isScancodeDown");
-	lua_pushstring(L, "lctrl");
+	lua_getfield(L, -1, "data");
+	lua_getfield(L, -1, "newByteData");
+	lua_pushnumber(L, size);
 	lua_call(L, 1, 1);
-	int lctrl = lua_toboolean(L, -1);
-	lua_pop(L, 3);
-
-	if (!strcmp(key, "rshift") || !strcmp(key, "lshift"))
-		nk_input_key(ctx, NK_KEY_SHIFT, down);
-	else if (!strcmp(key, "delete"))
-		nk_input_key(ctx, NK_KEY_DEL, down);
-	else if (!strcmp(key, "return"))
-		nk_input_key(ctx, NK_KEY_ENTER, down);
-	else if (!strcmp(key, "tab"))
-		nk_input_key(ctx, NK_KEY_TAB, down);
-	else if (!strcmp(key, "backspace"))
-		nk_input_key(ctx, NK_KEY_BACKSPACE, down);
-	else if (!strcmp(key, "home")) {
-		nk_input_key(ctx, NK_KEY_TEXT_LINE_START, down);
-	} else if (!strcmp(key, "end")) {
-		nk_input_key(ctx, NK_KEY_TEXT_LINE_END, down);
-	} else if (!strcmp(key, "pagedown")) {
-		nk_input_key(ctx, NK_KEY_SCROLL_DOWN, down);
-	} else if (!strcmp(key, "pageup")) {
-		nk_input_key(ctx, NK_KEY_SCROLL_UP, down);
-	} else if (!strcmp(key, "z"))
-		nk_input_key(ctx, NK_KEY_TEXT_UNDO, down && lctrl);
-	else if (!strcmp(key, "r"))
-		nk_input_key(ctx, NK_KEY_TEXT_REDO, down && lctrl);
-	else if (!strcmp(key, "c"))
-		nk_input_key(ctx, NK_KEY_COPY, down && lctrl);
-	else if (!strcmp(key, "v"))
-		nk_input_key(ctx, NK_KEY_PASTE, down && lctrl);
-	else if (!strcmp(key, "x"))
-		nk_input_key(ctx, NK_KEY_CUT, down && lctrl);
-	else if (!strcmp(key, "b"))
-		nk_input_key(ctx, NK_KEY_TEXT_LINE_START, down && lctrl);
-	else if (!strcmp(key, "e"))
-		nk_input_key(ctx, NK_KEY_TEXT_LINE_END, down && lctrl);
-	else if (!strcmp(key, "left")) {
-		if (lctrl)
-			nk_input_key(ctx, NK_KEY_TEXT_WORD_LEFT, down);
-		else
-			nk_input_key(ctx, NK_KEY_LEFT, down);
-	} else if (!strcmp(key, "right")) {
-		if (lctrl)
-			nk_input_key(ctx, NK_KEY_TEXT_WORD_RIGHT, down);
-		else
-			nk_input_key(ctx, NK_KEY_RIGHT, down);
-	} else if (!strcmp(key, "up"))
-		nk_input_key(ctx, NK_KEY_UP, down);
-	else if (!strcmp(key, "down"))
-		nk_input_key(ctx, NK_KEY_DOWN, down);
-	else
-		return 0;
-	return nk_love_is_active(ctx);
+	lua_replace(L, -3);
+	lua_pop(L, 1);
 }
 
-static int nk_love_clickevent(struct nk_love_context *ctx, int x, int y,
-	int button, int istouch, int presses, int down)
+static void nk_love_upload(lua_State *L, int index, const void *src, size_t size)
 {
-	nk_love_transform(ctx->Ti, &x, &y);
-	struct nk_context *nkctx = &ctx->nkctx;
-	if (button == 1)
-		nk_input_button(nkctx, NK_BUTTON_LEFT, x, y, down);
-	else if (button == 3)
-		nk_input_button(nkctx, NK_BUTTON_MIDDLE, x, y, down);
-	else if (button == 2)
-		nk_input_button(nkctx, NK_BUTTON_RIGHT, x, y, down);
-	else
-		return 0;
-	return nk_window_is_any_hovered(nkctx);
+	if (index < 0)
+		index += lua_gettop(L) + 1;
+	lua_getfield(L, index, "getPointer");
+	lua_pushvalue(L, index);
+	lua_call(L, 1, 1);
+	void *dst = lua_touserdata(L, -1);
+	lua_pop(L, 1);
+	memcpy(dst, src, size);
 }
 
-static int nk_love_mousemoved_event(struct nk_love_context *ctx, int x, int y,
-	int dx, int dy, int istouch)
+static void nk_love_batch_flush(lua_State *L, int nested, int px, int py, int pw, int ph)
 {
-	nk_love_transform(ctx->Ti, &x, &y);
-	struct nk_context *nkctx = &ctx->nkctx;
-	nk_input_motion(nkctx, x, y);
-	return nk_window_is_any_hovered(nkctx);
+	struct nk_love_batch *batch = &context->batch;
+	unsigned int vertex_count = batch->list.vertex_count;
+	unsigned int element_count = batch->list.element_count;
+	if (element_count == 0) {
+		nk_love_batch_reset(batch);
+		return;
+	}
+
+	nk_love_pushregistry(L, "batch");
+
+	if (vertex_count > batch->vertex_capacity) {
+		unsigned int capacity = NK_MAX(vertex_count, batch->vertex_capacity * 2);
+		capacity = NK_MAX(capacity, NK_LOVE_MIN_BATCH_VERTICES);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_NEW_MESH);
+		nk_love_push_vertex_format(L);
+		lua_pushnumber(L, capacity);
+		lua_pushstring(L, "triangles");
+		lua_pushstring(L, "stream");
+		lua_call(L, 4, 1);
+		lua_setfield(L, -2, "mesh");
+		nk_love_push_byte_data(L, capacity * sizeof(struct nk_love_vertex));
+		lua_setfield(L, -2, "vertices");
+		batch->vertex_capacity = capacity;
+	}
+	if (element_count > batch->element_capacity) {
+		unsigned int capacity = NK_MAX(element_count, batch->element_capacity * 2);
+		capacity = NK_MAX(capacity, NK_LOVE_MIN_BATCH_ELEMENTS);
+		nk_love_push_byte_data(L, capacity * sizeof(nk_draw_index));
+		lua_setfield(L, -2, "elements");
+		batch->element_capacity = capacity;
+	}
+
+	lua_getfield(L, -1, "mesh");
+
+	lua_getfield(L, -2, "vertices");
+	nk_love_upload(L, -1, nk_buffer_memory_const(&batch->vertices),
+		vertex_count * sizeof(struct nk_love_vertex));
+	lua_getfield(L, -2, "setVertices");
+	lua_pushvalue(L, -3);
+	lua_pushvalue(L, -3);
+	lua_pushnumber(L, 1);
+	lua_pushnumber(L, vertex_count);
+	lua_call(L, 4, 0);
+	lua_pop(L, 1);
+
+	lua_getfield(L, -2, "elements");
+	nk_love_upload(L, -1, nk_buffer_memory_const(&batch->elements),
+		element_count * sizeof(nk_draw_index));
+	lua_getfield(L, -2, "setVertexMap");
+	lua_pushvalue(L, -3);
+	lua_pushvalue(L, -3);
+	lua_pushstring(L, "uint32");
+	lua_call(L, 3, 0);
+	lua_pop(L, 1);
+
+	nk_love_set_color(L, nk_rgba(255, 255, 255, 255));
+
+	const struct nk_draw_command *cmd;
+	unsigned int offset = 0;
+	nk_draw_list_foreach(cmd, &batch->list, &batch->cmds)
+	{
+		if (!cmd->elem_count)
+			continue;
+		nk_love_scissor(L, cmd->clip_rect.x, cmd->clip_rect.y,
+			cmd->clip_rect.w, cmd->clip_rect.h, nested, px, py, pw, ph);
+		lua_getfield(L, -1, "setTexture");
+		lua_pushvalue(L, -2);
+		if (cmd->texture.id) {
+			nk_love_pushregistry(L, "image");
+			lua_rawgeti(L, -1, cmd->texture.id);
+			lua_rawgeti(L, -1, 1);
+			lua_replace(L, -3);
+			lua_pop(L, 1);
+			lua_call(L, 2, 0);
+		} else {
+			lua_call(L, 1, 0);
+		}
+		lua_getfield(L, -1, "setDrawRange");
+		lua_pushvalue(L, -2);
+		lua_pushnumber(L, offset + 1);
+		lua_pushnumber(L, cmd->elem_count);
+		lua_call(L, 3, 0);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_DRAW);
+		lua_pushvalue(L, -2);
+		lua_call(L, 1, 0);
+		offset += cmd->elem_count;
+	}
+
+	lua_pop(L, 2);
+	nk_love_batch_reset(batch);
 }
 
-static int nk_love_textinput_event(struct nk_context *ctx, const char *text)
+static void nk_love_batch_ellipse(lua_State *L, struct nk_draw_list *list, int x, int y,
+	unsigned int w, unsigned int h, int line_thickness, struct nk_color col)
 {
-	nk_rune rune;
-	nk_utf_decode(text, &rune, strlen(text));
-	nk_input_unicode(ctx, rune);
-	return nk_love_is_active(ctx);
+	float rx = w / 2.0f, ry = h / 2.0f;
+	float cx = x + rx, cy = y + ry;
+	unsigned int segments = nk_love_arc_segments(NK_MAX(rx, ry), 2 * NK_PI);
+	const float *circle = nk_love_unit_circle(L, &segments);
+	unsigned int i;
+	nk_draw_list_path_clear(list);
+	for (i = 0; i < segments; ++i) {
+		nk_draw_list_path_line_to(list, nk_vec2(cx + circle[i * 2] * rx,
+			cy + circle[i * 2 + 1] * ry));
+	}
+	if (line_thickness >= 0)
+		nk_draw_list_path_stroke(list, col, NK_STROKE_CLOSED, line_thickness);
+	else
+		nk_draw_list_path_fill(list, col);
 }
 
-static int nk_love_wheelmoved_event(struct nk_context *ctx, int x, int y)
+static void nk_love_batch_arc(struct nk_draw_list *list, int cx, int cy,
+	unsigned int r, int line_thickness, float a1, float a2, struct nk_color col)
 {
-	struct nk_vec2 scroll;
-	scroll.x = x;
-	scroll.y = y;
-	nk_input_scroll(ctx, scroll);
-	return nk_window_is_any_hovered(ctx);
+	nk_draw_list_path_line_to(list, nk_vec2(cx, cy));
+	nk_draw_list_path_arc_to(list, nk_vec2(cx, cy), r, a1, a2,
+		nk_love_arc_segments(r, a2 - a1));
+	if (line_thickness >= 0)
+		nk_draw_list_path_stroke(list, col, NK_STROKE_CLOSED, line_thickness);
+	else
+		nk_draw_list_path_fill(list, col);
 }
 
-/*
- * ===============================================================
- *
- *                          WRAPPER
- *
- * ===============================================================
- */
+static void nk_love_batch_points(struct nk_draw_list *list,
+	const struct nk_vec2i *pnts, int count, enum nk_draw_list_stroke closed,
+	int line_thickness, struct nk_color col)
+{
+	int i;
+	for (i = 0; i < count; ++i)
+		nk_draw_list_path_line_to(list, nk_vec2(pnts[i].x, pnts[i].y));
+	if (line_thickness >= 0)
+		nk_draw_list_path_stroke(list, col, closed, line_thickness);
+	else
+		nk_draw_list_path_fill(list, col);
+}
 
-static int nk_love_new_ui(lua_State *L)
+static void nk_love_draw_batched(lua_State *L, const struct nk_command *begin,
+	const struct nk_command *end, int nested, int px, int py, int pw, int ph)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 0);
-	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
-	struct nk_love_context *ctx = lua_newuserdata(L, sizeof(struct nk_love_context));
-	nk_love_assert_alloc(L, ctx);
-	lua_pushlightuserdata(L, ctx);
-	lua_newtable(L);
-	lua_newtable(L);
-	lua_setfield(L, -2, "font");
-	lua_newtable(L);
-	lua_setfield(L, -2, "image");
-	lua_newtable(L);
-	lua_setfield(L, -2, "stack");
-	lua_settable(L, -4);
-	lua_getfield(L, -2, "metatable");
-	lua_setmetatable(L, -2);
-	ctx->fonts = nk_love_malloc(L, sizeof(struct nk_love_font) * NK_LOVE_MAX_FONTS);
-	lua_getglobal(L, "love");
-	nk_love_assert(L, lua_istable(L, -1), "LOVE-Nuklear requires LOVE environment");
-	lua_getfield(L, -1, "graphics");
-	lua_getfield(L, -1, "getFont");
-	lua_call(L, 0, 1);
-	struct nk_love_context *current = context;
-	context = ctx;
-	nk_love_checkFont(L, -1, &ctx->fonts[0]);
-	context = current;
-	nk_init_default(&ctx->nkctx, &ctx->fonts[0].font);
-	ctx->font_count = 1;
-	ctx->nkctx.clip.copy = nk_love_clipboard_copy;
-	ctx->nkctx.clip.paste = nk_love_clipboard_paste;
-	ctx->nkctx.clip.userdata = nk_handle_ptr(L);
-	ctx->layout_ratios = nk_love_malloc(L, sizeof(float) * NK_LOVE_MAX_RATIOS);
-	ctx->layout_ratio_count = 0;
-	lua_pop(L, 3);
-	return 1;
-}
-
-static int nk_love_destroy(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	nk_free(&ctx->nkctx);
-	free(ctx->fonts);
-	free(ctx->layout_ratios);
-	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
-	lua_pushlightuserdata(L, ctx);
-	lua_pushnil(L);
-	lua_settable(L, -3);
-	return 0;
-}
-
-static int nk_love_keypressed(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 4);
-	struct nk_context *ctx = &nk_love_checkcontext(L, 1)->nkctx;
-	const char *key = luaL_checkstring(L, 2);
-	const char *scancode = luaL_checkstring(L, 3);
-	int isrepeat = nk_love_checkboolean(L, 4);
-	int consume = nk_love_keyevent(L, ctx, key, scancode, isrepeat, 1);
-	lua_pushboolean(L, consume);
-	return 1;
-}
-
-static int nk_love_keyreleased(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 3);
-	struct nk_context *ctx = &nk_love_checkcontext(L, 1)->nkctx;
-	const char *key = luaL_checkstring(L, 2);
-	const char *scancode = luaL_checkstring(L, 3);
-	int consume = nk_love_keyevent(L, ctx, key, scancode, 0, 0);
-	lua_pushboolean(L, consume);
-	return 1;
-}
-
-static int nk_love_mousepressed(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 5 || lua_gettop(L) == 6);
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	int x = luaL_checkint(L, 2);
-	int y = luaL_checkint(L, 3);
-	int button = luaL_checkint(L, 4);
-	int istouch = nk_love_checkboolean(L, 5);
-	int presses = lua_gettop(L) == 6 ? luaL_checkint(L, 6) : 1;
-	int consume = nk_love_clickevent(ctx, x, y, button, istouch, presses, 1);
-	lua_pushboolean(L, consume);
-	return 1;
-}
-
-static int nk_love_mousereleased(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 5 || lua_gettop(L) == 6);
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	int x = luaL_checkint(L, 2);
-	int y = luaL_checkint(L, 3);
-	int button = luaL_checkint(L, 4);
-	int istouch = nk_love_checkboolean(L, 5);
-	int presses = lua_gettop(L) == 6 ? luaL_checkint(L, 6) : 1;
-	int consume = nk_love_clickevent(ctx, x, y, button, istouch, presses, 0);
-	lua_pushboolean(L, consume);
-	return 1;
-}
-
-static int nk_love_mousemoved(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 6);
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	int x = luaL_checkint(L, 2);
-	int y = luaL_checkint(L, 3);
-	int dx = luaL_checkint(L, 4);
-	int dy = luaL_checkint(L, 5);
-	int istouch = nk_love_checkboolean(L, 6);
-	int consume = nk_love_mousemoved_event(ctx, x, y, dx, dy, istouch);
-	lua_pushboolean(L, consume);
-	return 1;
-}
-
-static int nk_love_textinput(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	struct nk_context *ctx = &nk_love_checkcontext(L, 1)->nkctx;
-	const char *text = luaL_checkstring(L, 2);
-	int consume = nk_love_textinput_event(ctx, text);
-	lua_pushboolean(L, consume);
-	return 1;
-}
-
-static int nk_love_wheelmoved(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 3);
-	struct nk_context *ctx = &nk_love_checkcontext(L, 1)->nkctx;
-	int x = luaL_checkint(L, 2);
-	int y = luaL_checkint(L, 3);
-	int consume = nk_love_wheelmoved_event(ctx, x, y);
-	lua_pushboolean(L, consume);
-	return 1;
-}
-
-static int nk_love_draw(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	context = nk_love_checkcontext(L, 1);
-
-	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "graphics");
-
-	lua_getfield(L, -1, "push");
-	lua_pushstring(L, "all");
-	lua_call(L, 1, 0);
-
-	lua_getfield(L, -1, "origin");
-	lua_call(L, 0, 0);
-
-	int nest_scissor = 0;
-	int px = 0, py = 0, pw = 0, ph = 0;
-	lua_getfield(L, -1, "getScissor");
-	lua_call(L, 0, 4);
-	if (lua_isnumber(L, -4)) {
-		nest_scissor = 1;
-		px = lua_tonumber(L, -4);
-		py = lua_tonumber(L, -3);
-		pw = lua_tonumber(L, -2);
-		ph = lua_tonumber(L, -1);
-	}
-	lua_pop(L, 4);
-
-	nk_love_pushregistry(L, "transform");
-	size_t transform_count = lua_objlen(L, -1);
-	size_t i, j;
-	for (i = 1; i <= transform_count; ++i) {
-		lua_rawgeti(L, -1, i);
-		lua_rawgeti(L, -1, 1);
-		lua_gettable(L, -4);
-		size_t transform_size = lua_objlen(L, -2);
-		for (j = 2; j <= transform_size; ++j)
-			lua_rawgeti(L, -j, j);
-		lua_call(L, transform_size - 1, 0);
-		lua_pop(L, 1);
-	}
-	lua_pop(L, 1);
+	struct nk_draw_list *list = &context->batch.list;
+	list->clip_rect = nk_null_rect;
+	nk_love_batch_reset(&context->batch);
 
 	const struct nk_command *cmd;
-	nk_foreach(cmd, &context->nkctx)
+	for (cmd = begin; cmd != end; cmd = nk__next(&context->nkctx, cmd))
 	{
 		switch (cmd->type) {
 		case NK_COMMAND_NOP: break;
 		case NK_COMMAND_SCISSOR: {
-			const struct nk_command_scissor *s =(const struct nk_command_scissor*)cmd;
-			nk_love_scissor(L, s->x, s->y, s->w, s->h, nest_scissor, px, py, pw, ph);
+			const struct nk_command_scissor *s = (const struct nk_command_scissor*)cmd;
+			nk_draw_list_add_clip(list, nk_rect(s->x, s->y, s->w, s->h));
 		} break;
 		case NK_COMMAND_LINE: {
 			const struct nk_command_line *l = (const struct nk_command_line *)cmd;
-			nk_love_draw_line(L, l->begin.x, l->begin.y, l->end.x,
-				l->end.y, l->line_thickness, l->color);
+			nk_draw_list_stroke_line(list, nk_vec2(l->begin.x, l->begin.y),
+				nk_vec2(l->end.x, l->end.y), l->color, l->line_thickness);
 		} break;
 		case NK_COMMAND_RECT: {
 			const struct nk_command_rect *r = (const struct nk_command_rect *)cmd;
-			nk_love_draw_rect(L, r->x, r->y, r->w, r->h,
-				(unsigned int)r->rounding, r->line_thickness, r->color);
+			nk_draw_list_stroke_rect(list, nk_rect(r->x, r->y, r->w, r->h),
+				r->color, r->rounding, r->line_thickness);
 		} break;
 		case NK_COMMAND_RECT_FILLED: {
 			const struct nk_command_rect_filled *r = (const struct nk_command_rect_filled *)cmd;
-			nk_love_draw_rect(L, r->x, r->y, r->w, r->h, (unsigned int)r->rounding, -1, r->color);
+			nk_draw_list_fill_rect(list, nk_rect(r->x, r->y, r->w, r->h),
+				r->color, r->rounding);
 		} break;
 		case NK_COMMAND_CIRCLE: {
 			const struct nk_command_circle *c = (const struct nk_command_circle *)cmd;
-			nk_love_draw_circle(L, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
+			nk_love_batch_ellipse(L, list, c->x, c->y, c->w, c->h, c->line_thickness, c->color);
 		} break;
 		case NK_COMMAND_CIRCLE_FILLED: {
 			const struct nk_command_circle_filled *c = (const struct nk_command_circle_filled *)cmd;
-			nk_love_draw_circle(L, c->x, c->y, c->w, c->h, -1, c->color);
+			nk_love_batch_ellipse(L, list, c->x, c->y, c->w, c->h, -1, c->color);
 		} break;
 		case NK_COMMAND_TRIANGLE: {
 			const struct nk_command_triangle *t = (const struct nk_command_triangle*)cmd;
-			nk_love_draw_triangle(L, t->a.x, t->a.y, t->b.x, t->b.y,
-				t->c.x, t->c.y, t->line_thickness, t->color);
+			nk_draw_list_stroke_triangle(list, nk_vec2(t->a.x, t->a.y),
+				nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color,
+				t->line_thickness);
 		} break;
 		case NK_COMMAND_TRIANGLE_FILLED: {
 			const struct nk_command_triangle_filled *t = (const struct nk_command_triangle_filled *)cmd;
-			nk_love_draw_triangle(L, t->a.x, t->a.y, t->b.x, t->b.y, t->c.x, t->c.y, -1, t->color);
+			nk_draw_list_fill_triangle(list, nk_vec2(t->a.x, t->a.y),
+				nk_vec2(t->b.x, t->b.y), nk_vec2(t->c.x, t->c.y), t->color);
 		} break;
 		case NK_COMMAND_POLYGON: {
-			const struct nk_command_polygon *p =(const struct nk_command_polygon*)cmd;
-			nk_love_draw_polygon(L, p->points, p->point_count, p->line_thickness, p->color);
+			const struct nk_command_polygon *p = (const struct nk_command_polygon*)cmd;
+			nk_love_batch_points(list, p->points, p->point_count, NK_STROKE_CLOSED,
+				p->line_thickness, p->color);
 		} break;
 		case NK_COMMAND_POLYGON_FILLED: {
 			const struct nk_command_polygon_filled *p = (const struct nk_command_polygon_filled*)cmd;
-			nk_love_draw_polygon(L, p->points, p->point_count, -1, p->color);
+			nk_love_batch_points(list, p->points, p->point_count, NK_STROKE_CLOSED,
+				-1, p->color);
 		} break;
 		case NK_COMMAND_POLYLINE: {
 			const struct nk_command_polyline *p = (const struct nk_command_polyline *)cmd;
-			nk_love_draw_polyline(L, p->points, p->point_count, p->line_thickness, p->color);
+			nk_love_batch_points(list, p->points, p->point_count, NK_STROKE_OPEN,
+				p->line_thickness, p->color);
 		} break;
 		case NK_COMMAND_TEXT: {
 			const struct nk_command_text *t = (const struct nk_command_text*)cmd;
 			struct nk_love_handle *love_handle = t->font->userdata.ptr;
+			struct nk_rect clip = list->clip_rect;
+			nk_love_batch_flush(L, nested, px, py, pw, ph);
+			nk_love_scissor(L, clip.x, clip.y, clip.w, clip.h, nested, px, py, pw, ph);
 			nk_love_draw_text(love_handle->L, love_handle->ref, t->background,
 				t->foreground, t->x, t->y, t->w, t->h,
 				t->height, t->length, (const char*)t->string);
 		} break;
 		case NK_COMMAND_CURVE: {
 			const struct nk_command_curve *q = (const struct nk_command_curve *)cmd;
-			nk_love_draw_curve(L, q->begin, q->ctrl[0], q->ctrl[1],
-				q->end, 22, q->line_thickness, q->color);
+			nk_draw_list_stroke_curve(list, nk_vec2(q->begin.x, q->begin.y),
+				nk_vec2(q->ctrl[0].x, q->ctrl[0].y), nk_vec2(q->ctrl[1].x, q->ctrl[1].y),
+				nk_vec2(q->end.x, q->end.y), q->color,
+				nk_love_curve_segments(q->begin, q->ctrl[0], q->ctrl[1], q->end),
+				q->line_thickness);
 		} break;
 		case NK_COMMAND_RECT_MULTI_COLOR: {
 			const struct nk_command_rect_multi_color *r = (const struct nk_command_rect_multi_color *)cmd;
-			nk_love_draw_rect_multi_color(L, r->x, r->y, r->w, r->h, r->left, r->top, r->bottom, r->right);
+			nk_draw_list_fill_rect_multi_color(list, nk_rect(r->x, r->y, r->w, r->h),
+				r->left, r->top, r->right, r->bottom);
 		} break;
 		case NK_COMMAND_IMAGE: {
 			const struct nk_command_image *i = (const struct nk_command_image *)cmd;
-			nk_love_draw_image(L, i->x, i->y, i->w, i->h, i->img, i->col);
+			nk_draw_list_add_image(list, i->img, nk_rect(i->x, i->y, i->w, i->h), i->col);
+			nk_draw_list_push_image(list, nk_handle_id(0));
 		} break;
 		case NK_COMMAND_ARC: {
 			const struct nk_command_arc *a = (const struct nk_command_arc *)cmd;
-			nk_love_draw_arc(L, a->cx, a->cy, a->r, a->line_thickness,
+			nk_love_batch_arc(list, a->cx, a->cy, a->r, a->line_thickness,
 				a->a[0], a->a[1], a->color);
 		} break;
 		case NK_COMMAND_ARC_FILLED: {
 			const struct nk_command_arc_filled *a = (const struct nk_command_arc_filled *)cmd;
-			nk_love_draw_arc(L, a->cx, a->cy, a->r, -1, a->a[0], a->a[1], a->color);
+			nk_love_batch_arc(list, a->cx, a->cy, a->r, -1, a->a[0], a->a[1], a->color);
 		} break;
 		default: break;
 		}
 	}
 
-	lua_getfield(L, -1, "pop");
-	lua_call(L, 0, 0);
-	lua_pop(L, 2);
-	nk_clear(&context->nkctx);
-	context = NULL;
-	return 0;
+	nk_love_batch_flush(L, nested, px, py, pw, ph);
 }
 
-static void nk_love_preserve(lua_State *L, struct nk_style_item *item)
+static void nk_love_draw_span(lua_State *L, const struct nk_command *begin,
+	const struct nk_command *end, int nested, int px, int py, int pw, int ph)
 {
-	if (item->type == NK_STYLE_ITEM_IMAGE) {
-		lua_rawgeti(L, -1, item->data.image.handle.id);
-		nk_love_checkImage(L, -1, &item->data.image);
-		lua_pop(L, 1);
-	}
+	if (context->render_mode == NK_LOVE_RENDER_BATCHED)
+		nk_love_draw_batched(L, begin, end, nested, px, py, pw, ph);
+	else
+		nk_love_draw_immediate(L, begin, end, nested, px, py, pw, ph);
 }
 
-static void nk_love_preserve_all(lua_State *L)
+static nk_size nk_love_command_offset(const struct nk_command *cmd)
 {
-	nk_love_preserve(L, &context->nkctx.style.button.normal);
-	nk_love_preserve(L, &context->nkctx.style.button.hover);
-	nk_love_preserve(L, &context->nkctx.style.button.active);
-
-	nk_love_preserve(L, &context->nkctx.style.contextual_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.contextual_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.contextual_button.active);
+	return (const nk_byte *) cmd - (const nk_byte *) context->nkctx.memory.memory.ptr;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.menu_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.menu_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.menu_button.active);
+static nk_hash nk_love_hash_window(lua_State *L, struct nk_love_window_cache *cache,
+	const struct nk_command *begin, const struct nk_command **end)
+{
+	nk_hash hash = cache->x * 31 + cache->y;
+	const struct nk_command *cmd = begin;
+	while (cmd) {
+		nk_size offset = nk_love_command_offset(cmd);
+		if (offset < cache->begin || offset >= cache->end)
+			break;
+		nk_size next = cmd->next;
+		if (next <= offset || next > cache->end)
+			next = cache->end;
+		hash = nk_murmur_hash((const nk_byte *) cmd + sizeof(struct nk_command),
+			(int) (next - offset - sizeof(struct nk_command)), hash ^ cmd->type);
+		if (cmd->type == NK_COMMAND_TEXT) {
+			const struct nk_command_text *t = (const struct nk_command_text *)cmd;
+			struct nk_love_handle *love_handle = t->font->userdata.ptr;
+			hash = nk_murmur_hash(&love_handle->metrics, sizeof(love_handle->metrics), hash);
+		} else if (cmd->type == NK_COMMAND_IMAGE) {
+			const struct nk_command_image *i = (const struct nk_command_image *)cmd;
+			const void *pointers[2];
+			nk_love_pushregistry(L, "image");
+			lua_rawgeti(L, -1, i->img.handle.id);
+			lua_rawgeti(L, -1, 1);
+			pointers[0] = lua_topointer(L, -1);
+			lua_rawgeti(L, -2, 2);
+			pointers[1] = lua_topointer(L, -1);
+			lua_pop(L, 4);
+			hash = nk_murmur_hash(pointers, sizeof(pointers), hash);
+		}
+		cmd = nk__next(&context->nkctx, cmd);
+	}
+	*end = cmd;
+	return hash;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.option.normal);
-	nk_love_preserve(L, &context->nkctx.style.option.hover);
-	nk_love_preserve(L, &context->nkctx.style.option.active);
-	nk_love_preserve(L, &context->nkctx.style.option.cursor_normal);
-	nk_love_preserve(L, &context->nkctx.style.option.cursor_hover);
+static void nk_love_draw_window_cached(lua_State *L, struct nk_love_window_cache *cache,
+	const struct nk_command *begin, const struct nk_command *end,
+	int nested, int px, int py, int pw, int ph)
+{
+	nk_love_pushregistry(L, "canvas");
+	lua_rawgeti(L, -1, cache->name);
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_NEW_CANVAS);
+		lua_pushnumber(L, cache->w);
+		lua_pushnumber(L, cache->h);
+		lua_call(L, 2, 1);
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, -3, cache->name);
+	}
 
-	nk_love_preserve(L, &context->nkctx.style.checkbox.normal);
-	nk_love_preserve(L, &context->nkctx.style.checkbox.hover);
-	nk_love_preserve(L, &context->nkctx.style.checkbox.active);
-	nk_love_preserve(L, &context->nkctx.style.checkbox.cursor_normal);
-	nk_love_preserve(L, &context->nkctx.style.checkbox.cursor_hover);
+	if (cache->valid) {
+		context->stats.window_cache_hits++;
+	} else {
+		context->stats.window_renders++;
+		struct nk_love_graphics_state state = context->state;
+		float T[9];
+		memcpy(T, context->T, sizeof(T));
+		int i;
+		for (i = 0; i < 9; ++i)
+			context->T[i] = (i % 3 == i / 3);
+		context->T[6] = -cache->x;
+		context->T[7] = -cache->y;
+		memset(&context->state, 0, sizeof(context->state));
+
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_PUSH);
+		lua_pushstring(L, "all");
+		lua_call(L, 1, 0);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_ORIGIN);
+		lua_call(L, 0, 0);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_SET_CANVAS);
+		lua_pushvalue(L, -2);
+		lua_call(L, 1, 0);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_CLEAR);
+		lua_pushnumber(L, 0);
+		lua_pushnumber(L, 0);
+		lua_pushnumber(L, 0);
+		lua_pushnumber(L, 0);
+		lua_call(L, 4, 0);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_TRANSLATE);
+		lua_pushnumber(L, -cache->x);
+		lua_pushnumber(L, -cache->y);
+		lua_call(L, 2, 0);
+		nk_love_draw_span(L, begin, end, 0, 0, 0, 0, 0);
+		nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_POP);
+		lua_call(L, 0, 0);
+
+		memcpy(context->T, T, sizeof(T));
+		context->state = state;
+		cache->valid = 1;
+	}
 
-	nk_love_preserve(L, &context->nkctx.style.selectable.normal);
-	nk_love_preserve(L, &context->nkctx.style.selectable.hover);
-	nk_love_preserve(L, &context->nkctx.style.selectable.pressed);
-	nk_love_preserve(L, &context->nkctx.style.selectable.normal_active);
-	nk_love_preserve(L, &context->nkctx.style.selectable.hover_active);
-	nk_love_preserve(L, &context->nkctx.style.selectable.pressed_active);
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_SET_SCISSOR);
+	if (nested) {
+		lua_pushnumber(L, px);
+		lua_pushnumber(L, py);
+		lua_pushnumber(L, pw);
+		lua_pushnumber(L, ph);
+		lua_call(L, 4, 0);
+	} else {
+		lua_call(L, 0, 0);
+	}
+	context->state.has_scissor = 0;
+	nk_love_set_color(L, nk_rgba(255, 255, 255, 255));
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_SET_BLEND_MODE);
+	lua_pushstring(L, "alpha");
+	lua_pushstring(L, "premultiplied");
+	lua_call(L, 2, 0);
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_DRAW);
+	lua_pushvalue(L, -2);
+	lua_pushnumber(L, cache->x);
+	lua_pushnumber(L, cache->y);
+	lua_call(L, 3, 0);
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_SET_BLEND_MODE);
+	lua_pushstring(L, "alpha");
+	lua_call(L, 1, 0);
+	lua_pop(L, 2);
+}
 
-	nk_love_preserve(L, &context->nkctx.style.slider.normal);
-	nk_love_preserve(L, &context->nkctx.style.slider.hover);
-	nk_love_preserve(L, &context->nkctx.style.slider.active);
-	nk_love_preserve(L, &context->nkctx.style.slider.cursor_normal);
-	nk_love_preserve(L, &context->nkctx.style.slider.cursor_hover);
-	nk_love_preserve(L, &context->nkctx.style.slider.cursor_active);
+static void nk_love_update_window_cache(lua_State *L, struct nk_love_window_cache *cache)
+{
+	struct nk_window *win;
+	cache->begin = cache->end = 0;
+	for (win = context->nkctx.begin; win != NULL; win = win->next) {
+		if (win->name == cache->name)
+			break;
+	}
+	if (win == NULL || (win->flags & NK_WINDOW_HIDDEN) || win->buffer.begin == win->buffer.end)
+		return;
+	/* Popup and tooltip commands live inside the window's buffer but are
+	 * linked after the last window, so the span would be split in two.
+	 * Draw such windows uncached and leave the canvas for later frames.
+	 * nk_build clears the popup buffer flag, so it is only read before the
+	 * frame is built. */
+	if (!context->nkctx.build)
+		cache->popup = win->popup.buf.active;
+	if (cache->popup)
+		return;
+	struct nk_rect bounds = win->bounds;
+	int x = (int) floorf(bounds.x) - NK_LOVE_CANVAS_PADDING;
+	int y = (int) floorf(bounds.y) - NK_LOVE_CANVAS_PADDING;
+	int w = (int) ceilf(bounds.x + bounds.w) + NK_LOVE_CANVAS_PADDING - x;
+	int h = (int) ceilf(bounds.y + bounds.h) + NK_LOVE_CANVAS_PADDING - y;
+	if (w != cache->w || h != cache->h) {
+		nk_love_pushregistry(L, "canvas");
+		lua_pushnil(L);
+		lua_rawseti(L, -2, cache->name);
+		lua_pop(L, 1);
+		cache->valid = 0;
+	}
+	cache->x = x;
+	cache->y = y;
+	cache->w = w;
+	cache->h = h;
+	cache->begin = win->buffer.begin;
+	cache->end = win->buffer.end;
+}
+
+static void nk_love_draw_commands(lua_State *L, int nested, int px, int py, int pw, int ph)
+{
+	int i;
+	for (i = 0; i < context->window_cache_count; ++i)
+		nk_love_update_window_cache(L, &context->window_caches[i]);
+	const struct nk_command *begin = nk__begin(&context->nkctx);
+	if (context->window_cache_count == 0) {
+		nk_love_draw_span(L, begin, NULL, nested, px, py, pw, ph);
+		return;
+	}
+	const struct nk_command *cmd = begin;
+	while (cmd) {
+		nk_size offset = nk_love_command_offset(cmd);
+		struct nk_love_window_cache *cache = NULL;
+		for (i = 0; i < context->window_cache_count; ++i) {
+			struct nk_love_window_cache *c = &context->window_caches[i];
+			if (offset >= c->begin && offset < c->end) {
+				cache = c;
+				break;
+			}
+		}
+		if (cache == NULL) {
+			cmd = nk__next(&context->nkctx, cmd);
+			continue;
+		}
+		if (begin != cmd)
+			nk_love_draw_span(L, begin, cmd, nested, px, py, pw, ph);
+		const struct nk_command *end;
+		nk_hash hash = nk_love_hash_window(L, cache, cmd, &end);
+		if (hash != cache->hash)
+			cache->valid = 0;
+		cache->hash = hash;
+		nk_love_draw_window_cached(L, cache, cmd, end, nested, px, py, pw, ph);
+		begin = cmd = end;
+	}
+	if (begin != NULL)
+		nk_love_draw_span(L, begin, NULL, nested, px, py, pw, ph);
+}
+
+/*
+ * ===============================================================
+ *
+ *                            INPUT
+ *
+ * ===============================================================
+ */
+
+static void nk_love_clipboard_paste(nk_handle usr, struct nk_text_edit *edit)
+{
+	lua_State *L = usr.ptr;
+	lua_getglobal(L, "love");
+	lua_getfield(L, -1, "system");
+	lua_getfield(L, -1, "getClipboardText");
+	lua_call(L, 0, 1);
+	const char *text = lua_tostring(L, -1);
+	if (text && *text) {
+		nk_textedit_paste(edit, text, nk_strlen(text));
+		context->edit_changed = 1;
+	}
+	lua_pop(L, 3);
+}
+
+static void nk_love_clipboard_copy(nk_handle usr, const char *text, int len)
+{
+	lua_State *L = usr.ptr;
+	char *str = 0;
+	if (!len) return;
+	str = (char*)malloc((size_t)len+1);
+	if (!str) return;
+	memcpy(str, text, (size_t)len);
+	str[len] = '\0';
+	lua_getglobal(L, "love");
+	lua_getfield(L, -1, "system");
+	lua_getfield(L, -1, "setClipboardText");
+	lua_pushstring(L, str);
+	free(str);
+	lua_call(L, 1, 0);
+	lua_pop(L, 2);
+}
+
+static int nk_love_is_active(struct nk_context *ctx)
+{
+	struct nk_window *iter;
+	iter = ctx->begin;
+	while (iter) {
+		/* check if window is being hovered */
+		if (iter->flags & NK_WINDOW_MINIMIZED) {
+			struct nk_rect header = iter->bounds;
+			header.h = ctx->style.font->height + 2 * ctx->style.window.header.padding.y;
+			if (nk_input_is_mouse_hovering_rect(&ctx->input, header))
+				return 1;
+		} else if (nk_input_is_mouse_hovering_rect(&ctx->input, iter->bounds)) {
+			return 1;
+		}
+		/* check if window popup is being hovered */
+		if (iter->popup.active && iter->popup.win && nk_input_is_mouse_hovering_rect(&ctx->input, iter->popup.win->bounds))
+			return 1;
+		if (iter->edit.active & NK_EDIT_ACTIVE)
+			return 1;
+		iter = iter->next;
+	}
+	return 0;
+}
+
+static int nk_love_keyevent(lua_State *L, struct nk_context *ctx, const char *key,
+	const char *scancode, int isrepeat, int down)
+{
+	lua_getglobal(L, "love");
+	lua_getfield(L, -1, "keyboard");
+	lua_getfield(L, -1, "isScancodeDown");
+	lua_pushstring(L, "lctrl");
+	lua_call(L, 1, 1);
+	int lctrl = lua_toboolean(L, -1);
+	lua_pop(L, 3);
+
+	if (!strcmp(key, "rshift") || !strcmp(key, "lshift"))
+		nk_input_key(ctx, NK_KEY_SHIFT, down);
+	else if (!strcmp(key, "delete"))
+		nk_input_key(ctx, NK_KEY_DEL, down);
+	else if (!strcmp(key, "return"))
+		nk_input_key(ctx, NK_KEY_ENTER, down);
+	else if (!strcmp(key, "tab"))
+		nk_input_key(ctx, NK_KEY_TAB, down);
+	else if (!strcmp(key, "backspace"))
+		nk_input_key(ctx, NK_KEY_BACKSPACE, down);
+	else if (!strcmp(key, "home")) {
+		nk_input_key(ctx, NK_KEY_TEXT_LINE_START, down);
+	} else if (!strcmp(key, "end")) {
+		nk_input_key(ctx, NK_KEY_TEXT_LINE_END, down);
+	} else if (!strcmp(key, "pagedown")) {
+		nk_input_key(ctx, NK_KEY_SCROLL_DOWN, down);
+	} else if (!strcmp(key, "pageup")) {
+		nk_input_key(ctx, NK_KEY_SCROLL_UP, down);
+	} else if (!strcmp(key, "z"))
+		nk_input_key(ctx, NK_KEY_TEXT_UNDO, down && lctrl);
+	else if (!strcmp(key, "r"))
+		nk_input_key(ctx, NK_KEY_TEXT_REDO, down && lctrl);
+	else if (!strcmp(key, "c"))
+		nk_input_key(ctx, NK_KEY_COPY, down && lctrl);
+	else if (!strcmp(key, "v"))
+		nk_input_key(ctx, NK_KEY_PASTE, down && lctrl);
+	else if (!strcmp(key, "x"))
+		nk_input_key(ctx, NK_KEY_CUT, down && lctrl);
+	else if (!strcmp(key, "b"))
+		nk_input_key(ctx, NK_KEY_TEXT_LINE_START, down && lctrl);
+	else if (!strcmp(key, "e"))
+		nk_input_key(ctx, NK_KEY_TEXT_LINE_END, down && lctrl);
+	else if (!strcmp(key, "left")) {
+		if (lctrl)
+			nk_input_key(ctx, NK_KEY_TEXT_WORD_LEFT, down);
+		else
+			nk_input_key(ctx, NK_KEY_LEFT, down);
+	} else if (!strcmp(key, "right")) {
+		if (lctrl)
+			nk_input_key(ctx, NK_KEY_TEXT_WORD_RIGHT, down);
+		else
+			nk_input_key(ctx, NK_KEY_RIGHT, down);
+	} else if (!strcmp(key, "up"))
+		nk_input_key(ctx, NK_KEY_UP, down);
+	else if (!strcmp(key, "down"))
+		nk_input_key(ctx, NK_KEY_DOWN, down);
+	else
+		return 0;
+	return nk_love_is_active(ctx);
+}
+
+static int nk_love_clickevent(struct nk_love_context *ctx, int x, int y,
+	int button, int istouch, int presses, int down)
+{
+	nk_love_transform(ctx->Ti, &x, &y);
+	struct nk_context *nkctx = &ctx->nkctx;
+	if (button == 1)
+		nk_input_button(nkctx, NK_BUTTON_LEFT, x, y, down);
+	else if (button == 3)
+		nk_input_button(nkctx, NK_BUTTON_MIDDLE, x, y, down);
+	else if (button == 2)
+		nk_input_button(nkctx, NK_BUTTON_RIGHT, x, y, down);
+	else
+		return 0;
+	return nk_window_is_any_hovered(nkctx);
+}
+
+static int nk_love_mousemoved_event(struct nk_love_context *ctx, int x, int y,
+	int dx, int dy, int istouch)
+{
+	nk_love_transform(ctx->Ti, &x, &y);
+	struct nk_context *nkctx = &ctx->nkctx;
+	nk_input_motion(nkctx, x, y);
+	return nk_window_is_any_hovered(nkctx);
+}
+
+static int nk_love_textinput_event(struct nk_context *ctx, const char *text)
+{
+	nk_rune rune;
+	nk_utf_decode(text, &rune, strlen(text));
+	nk_input_unicode(ctx, rune);
+	return nk_love_is_active(ctx);
+}
+
+static int nk_love_wheelmoved_event(struct nk_context *ctx, int x, int y)
+{
+	struct nk_vec2 scroll;
+	scroll.x = x;
+	scroll.y = y;
+	nk_input_scroll(ctx, scroll);
+	return nk_window_is_any_hovered(ctx);
+}
+
+/*
+ * ===============================================================
+ *
+ *                          WRAPPER
+ *
+ * ===============================================================
+ */
+
+static int nk_love_new_ui(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 0);
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	struct nk_love_context *ctx = lua_newuserdata(L, sizeof(struct nk_love_context));
+	nk_love_assert_alloc(L, ctx);
+	lua_pushlightuserdata(L, ctx);
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_setfield(L, -2, "font");
+	lua_newtable(L);
+	lua_setfield(L, -2, "fontid");
+	lua_newtable(L);
+	lua_setfield(L, -2, "image");
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_pushstring(L, "k");
+	lua_setfield(L, -2, "__mode");
+	lua_setmetatable(L, -2);
+	lua_setfield(L, -2, "imageid");
+	lua_newtable(L);
+	lua_setfield(L, -2, "batch");
+	lua_newtable(L);
+	lua_setfield(L, -2, "canvas");
+	lua_newtable(L);
+	lua_setfield(L, -2, "text");
+	lua_settable(L, -4);
+	lua_getfield(L, -2, "metatable");
+	lua_setmetatable(L, -2);
+	ctx->fonts = NULL;
+	ctx->font_count = 0;
+	ctx->font_capacity = 0;
+	ctx->frame = 0;
+	lua_getglobal(L, "love");
+	nk_love_assert(L, lua_istable(L, -1), "LOVE-Nuklear requires LOVE environment");
+	lua_getfield(L, -1, "graphics");
+	lua_getfield(L, -1, "getFont");
+	lua_call(L, 0, 1);
+	struct nk_love_context *current = context;
+	context = ctx;
+	struct nk_love_font *font = nk_love_checkFont(L, -1);
+	context = current;
+	nk_init_default(&ctx->nkctx, &font->font);
+	ctx->nkctx.clip.copy = nk_love_clipboard_copy;
+	ctx->nkctx.clip.paste = nk_love_clipboard_paste;
+	ctx->nkctx.clip.userdata = nk_handle_ptr(L);
+	ctx->window_caches = nk_love_malloc(L, sizeof(struct nk_love_window_cache) * NK_LOVE_MAX_CACHED_WINDOWS);
+	ctx->window_cache_count = 0;
+	ctx->tessellation_error = NK_LOVE_DEFAULT_TESSELLATION_ERROR;
+	ctx->images = NULL;
+	ctx->image_capacity = 0;
+	ctx->transform_count = 0;
+	ctx->list_view_count = 0;
+	ctx->pen.color = nk_rgba(255, 255, 255, 255);
+	ctx->pen.line_width = 1;
+	ctx->pen_count = 0;
+	ctx->pen_sync = 0;
+	ctx->pen_font = NULL;
+	ctx->style_saves = NULL;
+	ctx->style_save_count = 0;
+	ctx->style_save_capacity = 0;
+	ctx->style_depth = 0;
+	ctx->style_frame_depth = 0;
+	ctx->style_images = NULL;
+	ctx->style_image_count = 0;
+	ctx->style_image_capacity = 0;
+	ctx->style_generation = 1;
+	ctx->style_scan = 0;
+	memset(&ctx->arena, 0, sizeof(ctx->arena));
+	ctx->heap_start = 0;
+	ctx->render_mode = NK_LOVE_RENDER_IMMEDIATE;
+	memset(&ctx->state, 0, sizeof(ctx->state));
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+	nk_love_batch_init(&ctx->batch);
+	lua_pop(L, 3);
+	return 1;
+}
+
+static int nk_love_destroy(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	nk_free(&ctx->nkctx);
+	int i;
+	for (i = 0; i < ctx->font_count; ++i)
+		free(ctx->fonts[i]);
+	free(ctx->fonts);
+	nk_love_arena_reset(&ctx->arena);
+	free(ctx->arena.blocks);
+	free(ctx->window_caches);
+	free(ctx->images);
+	free(ctx->style_saves);
+	free(ctx->style_images);
+	nk_love_batch_free(&ctx->batch);
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_pushlightuserdata(L, ctx);
+	lua_pushnil(L);
+	lua_settable(L, -3);
+	return 0;
+}
+
+static int nk_love_invalidate(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 0);
+	nk_love_invalidate_graphics(L);
+	return 0;
+}
+
+static int nk_love_keypressed(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 4);
+	struct nk_context *ctx = &nk_love_checkcontext(L, 1)->nkctx;
+	const char *key = luaL_checkstring(L, 2);
+	const char *scancode = luaL_checkstring(L, 3);
+	int isrepeat = nk_love_checkboolean(L, 4);
+	int consume = nk_love_keyevent(L, ctx, key, scancode, isrepeat, 1);
+	lua_pushboolean(L, consume);
+	return 1;
+}
+
+static int nk_love_keyreleased(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	struct nk_context *ctx = &nk_love_checkcontext(L, 1)->nkctx;
+	const char *key = luaL_checkstring(L, 2);
+	const char *scancode = luaL_checkstring(L, 3);
+	int consume = nk_love_keyevent(L, ctx, key, scancode, 0, 0);
+	lua_pushboolean(L, consume);
+	return 1;
+}
+
+static int nk_love_mousepressed(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 5 || lua_gettop(L) == 6);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	int x = luaL_checkint(L, 2);
+	int y = luaL_checkint(L, 3);
+	int button = luaL_checkint(L, 4);
+	int istouch = nk_love_checkboolean(L, 5);
+	int presses = lua_gettop(L) == 6 ? luaL_checkint(L, 6) : 1;
+	int consume = nk_love_clickevent(ctx, x, y, button, istouch, presses, 1);
+	lua_pushboolean(L, consume);
+	return 1;
+}
+
+static int nk_love_mousereleased(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 5 || lua_gettop(L) == 6);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	int x = luaL_checkint(L, 2);
+	int y = luaL_checkint(L, 3);
+	int button = luaL_checkint(L, 4);
+	int istouch = nk_love_checkboolean(L, 5);
+	int presses = lua_gettop(L) == 6 ? luaL_checkint(L, 6) : 1;
+	int consume = nk_love_clickevent(ctx, x, y, button, istouch, presses, 0);
+	lua_pushboolean(L, consume);
+	return 1;
+}
+
+static int nk_love_mousemoved(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 6);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	int x = luaL_checkint(L, 2);
+	int y = luaL_checkint(L, 3);
+	int dx = luaL_checkint(L, 4);
+	int dy = luaL_checkint(L, 5);
+	int istouch = nk_love_checkboolean(L, 6);
+	int consume = nk_love_mousemoved_event(ctx, x, y, dx, dy, istouch);
+	lua_pushboolean(L, consume);
+	return 1;
+}
+
+static int nk_love_textinput(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_context *ctx = &nk_love_checkcontext(L, 1)->nkctx;
+	const char *text = luaL_checkstring(L, 2);
+	int consume = nk_love_textinput_event(ctx, text);
+	lua_pushboolean(L, consume);
+	return 1;
+}
+
+static int nk_love_wheelmoved(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	struct nk_context *ctx = &nk_love_checkcontext(L, 1)->nkctx;
+	int x = luaL_checkint(L, 2);
+	int y = luaL_checkint(L, 3);
+	int consume = nk_love_wheelmoved_event(ctx, x, y);
+	lua_pushboolean(L, consume);
+	return 1;
+}
+
+static int nk_love_draw(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	context = nk_love_checkcontext(L, 1);
+	nk_love_resolve_graphics(L);
+
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_PUSH);
+	lua_pushstring(L, "all");
+	lua_call(L, 1, 0);
+
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_ORIGIN);
+	lua_call(L, 0, 0);
+
+	memset(&context->state, 0, sizeof(context->state));
+
+	int nest_scissor = 0;
+	int px = 0, py = 0, pw = 0, ph = 0;
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_GET_SCISSOR);
+	lua_call(L, 0, 4);
+	if (lua_isnumber(L, -4)) {
+		nest_scissor = 1;
+		px = lua_tonumber(L, -4);
+		py = lua_tonumber(L, -3);
+		pw = lua_tonumber(L, -2);
+		ph = lua_tonumber(L, -1);
+	}
+	lua_pop(L, 4);
+
+	int i, j;
+	for (i = 0; i < context->transform_count; ++i) {
+		struct nk_love_transform *transform = &context->transforms[i];
+		nk_love_pushgraphics(L, transform->function);
+		for (j = 0; j < transform->argc; ++j)
+			lua_pushnumber(L, transform->args[j]);
+		lua_call(L, transform->argc, 0);
+	}
+
+	nk_love_draw_commands(L, nest_scissor, px, py, pw, ph);
+
+	nk_love_pushgraphics(L, NK_LOVE_GRAPHICS_POP);
+	lua_call(L, 0, 0);
+	context->stats.heap_growth = nk_love_heap_size(L) - context->heap_start;
+	nk_clear(&context->nkctx);
+	context = NULL;
+	return 0;
+}
+
+static int nk_love_set_render_mode(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	ctx->render_mode = nk_love_checkrendermode(L, 2);
+	return 0;
+}
+
+static int nk_love_get_render_mode(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	if (ctx->render_mode == NK_LOVE_RENDER_BATCHED)
+		lua_pushstring(L, "batched");
+	else
+		lua_pushstring(L, "immediate");
+	return 1;
+}
+
+static int nk_love_set_tessellation_quality(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	float error = luaL_checknumber(L, 2);
+	luaL_argcheck(L, error > 0, 2, "maximum error must be positive");
+	ctx->tessellation_error = error;
+	int i;
+	for (i = 0; i < ctx->window_cache_count; ++i)
+		ctx->window_caches[i].valid = 0;
+	return 0;
+}
+
+static int nk_love_get_tessellation_quality(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	lua_pushnumber(L, ctx->tessellation_error);
+	return 1;
+}
+
+static int nk_love_set_window_caching(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	size_t len;
+	const char *name = luaL_checklstring(L, 2, &len);
+	int enable = nk_love_checkboolean(L, 3);
+	nk_hash hash = nk_murmur_hash(name, (int) len, NK_WINDOW_TITLE);
+	int i;
+	for (i = 0; i < ctx->window_cache_count; ++i) {
+		if (ctx->window_caches[i].name == hash)
+			break;
+	}
+	if (enable && i == ctx->window_cache_count) {
+		nk_love_assert(L, ctx->window_cache_count < NK_LOVE_MAX_CACHED_WINDOWS,
+			"%s: too many cached windows");
+		struct nk_love_window_cache *cache = &ctx->window_caches[ctx->window_cache_count++];
+		memset(cache, 0, sizeof(*cache));
+		cache->name = hash;
+	} else if (!enable && i < ctx->window_cache_count) {
+		ctx->window_caches[i] = ctx->window_caches[--ctx->window_cache_count];
+		struct nk_love_context *current = context;
+		context = ctx;
+		nk_love_pushregistry(L, "canvas");
+		context = current;
+		lua_pushnil(L);
+		lua_rawseti(L, -2, hash);
+		lua_pop(L, 1);
+	}
+	return 0;
+}
+
+static int nk_love_frame_stats(lua_State *L)
+{
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 1 && argc <= 2);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	if (argc == 2)
+		luaL_checktype(L, 2, LUA_TTABLE);
+	else
+		lua_newtable(L);
+	lua_pushnumber(L, ctx->stats.state_changes);
+	lua_setfield(L, -2, "stateChanges");
+	lua_pushnumber(L, ctx->stats.state_changes_skipped);
+	lua_setfield(L, -2, "stateChangesSkipped");
+	lua_pushnumber(L, ctx->stats.glyph_hits);
+	lua_setfield(L, -2, "glyphHits");
+	lua_pushnumber(L, ctx->stats.glyph_misses);
+	lua_setfield(L, -2, "glyphMisses");
+	lua_pushnumber(L, ctx->stats.window_cache_hits);
+	lua_setfield(L, -2, "windowCacheHits");
+	lua_pushnumber(L, ctx->stats.window_renders);
+	lua_setfield(L, -2, "windowRenders");
+	lua_pushnumber(L, ctx->stats.heap_growth);
+	lua_setfield(L, -2, "heapGrowth");
+	lua_pushnumber(L, ctx->arena.used);
+	lua_setfield(L, -2, "scratchUsed");
+	lua_pushnumber(L, ctx->arena.high_water);
+	lua_setfield(L, -2, "scratchHighWater");
+	return 1;
+}
+
+/*
+ * Images used by the style are pinned so they are never released. The pins
+ * are only rebuilt when style_generation shows the style has changed in a
+ * way that outlives a frame: a reset, a push or pop outside a frame, a pop
+ * of a style pushed before the frame, or pushes left on the stack at
+ * ui:frameEnd(). Styles pushed and popped within a frame intern their
+ * images on every push, so they need no pins.
+ */
+static void nk_love_preserve(lua_State *L, struct nk_style_item *item)
+{
+	if (item->type != NK_STYLE_ITEM_IMAGE)
+		return;
+	if (context->style_image_count == context->style_image_capacity) {
+		int capacity = NK_MAX(context->style_image_capacity * 2, 16);
+		int *images = realloc(context->style_images, sizeof(int) * capacity);
+		nk_love_assert_alloc(L, images);
+		context->style_images = images;
+		context->style_image_capacity = capacity;
+	}
+	int id = item->data.image.handle.id;
+	context->style_images[context->style_image_count++] = id;
+	context->images[id].pinned++;
+}
+
+static void nk_love_preserve_all(lua_State *L)
+{
+	int i;
+	for (i = 0; i < context->style_image_count; ++i) {
+		struct nk_love_image_slot *slot = &context->images[context->style_images[i]];
+		slot->pinned--;
+		slot->frame = context->frame;
+	}
+	context->style_image_count = 0;
+	for (i = 0; i < context->style_save_count; ++i) {
+		struct nk_love_style_entry *save = &context->style_saves[i];
+		if (save->kind == NK_LOVE_STYLE_ITEM)
+			nk_love_preserve(L, &save->value.item);
+	}
+	nk_love_preserve(L, &context->nkctx.style.button.normal);
+	nk_love_preserve(L, &context->nkctx.style.button.hover);
+	nk_love_preserve(L, &context->nkctx.style.button.active);
+
+	nk_love_preserve(L, &context->nkctx.style.contextual_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.contextual_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.contextual_button.active);
+
+	nk_love_preserve(L, &context->nkctx.style.menu_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.menu_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.menu_button.active);
+
+	nk_love_preserve(L, &context->nkctx.style.option.normal);
+	nk_love_preserve(L, &context->nkctx.style.option.hover);
+	nk_love_preserve(L, &context->nkctx.style.option.active);
+	nk_love_preserve(L, &context->nkctx.style.option.cursor_normal);
+	nk_love_preserve(L, &context->nkctx.style.option.cursor_hover);
+
+	nk_love_preserve(L, &context->nkctx.style.checkbox.normal);
+	nk_love_preserve(L, &context->nkctx.style.checkbox.hover);
+	nk_love_preserve(L, &context->nkctx.style.checkbox.active);
+	nk_love_preserve(L, &context->nkctx.style.checkbox.cursor_normal);
+	nk_love_preserve(L, &context->nkctx.style.checkbox.cursor_hover);
+
+	nk_love_preserve(L, &context->nkctx.style.selectable.normal);
+	nk_love_preserve(L, &context->nkctx.style.selectable.hover);
+	nk_love_preserve(L, &context->nkctx.style.selectable.pressed);
+	nk_love_preserve(L, &context->nkctx.style.selectable.normal_active);
+	nk_love_preserve(L, &context->nkctx.style.selectable.hover_active);
+	nk_love_preserve(L, &context->nkctx.style.selectable.pressed_active);
+
+	nk_love_preserve(L, &context->nkctx.style.slider.normal);
+	nk_love_preserve(L, &context->nkctx.style.slider.hover);
+	nk_love_preserve(L, &context->nkctx.style.slider.active);
+	nk_love_preserve(L, &context->nkctx.style.slider.cursor_normal);
+	nk_love_preserve(L, &context->nkctx.style.slider.cursor_hover);
+	nk_love_preserve(L, &context->nkctx.style.slider.cursor_active);
 
 	nk_love_preserve(L, &context->nkctx.style.progress.normal);
 	nk_love_preserve(L, &context->nkctx.style.progress.hover);
@@ -1435,1578 +3081,2537 @@ static void nk_love_preserve_all(lua_State *L)
 	nk_love_preserve(L, &context->nkctx.style.progress.cursor_hover);
 	nk_love_preserve(L, &context->nkctx.style.progress.cursor_active);
 
-	nk_love_preserve(L, &context->nkctx.style.property.normal);
-	nk_love_preserve(L, &context->nkctx.style.property.hover);
-	nk_love_preserve(L, &context->nkctx.style.property.active);
-	nk_love_preserve(L, &context->nkctx.style.property.edit.normal);
-	nk_love_preserve(L, &context->nkctx.style.property.edit.hover);
-	nk_love_preserve(L, &context->nkctx.style.property.edit.active);
-	nk_love_preserve(L, &context->nkctx.style.property.inc_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.property.inc_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.property.inc_button.active);
-	nk_love_preserve(L, &context->nkctx.style.property.dec_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.property.dec_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.property.dec_button.active);
+	nk_love_preserve(L, &context->nkctx.style.property.normal);
+	nk_love_preserve(L, &context->nkctx.style.property.hover);
+	nk_love_preserve(L, &context->nkctx.style.property.active);
+	nk_love_preserve(L, &context->nkctx.style.property.edit.normal);
+	nk_love_preserve(L, &context->nkctx.style.property.edit.hover);
+	nk_love_preserve(L, &context->nkctx.style.property.edit.active);
+	nk_love_preserve(L, &context->nkctx.style.property.inc_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.property.inc_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.property.inc_button.active);
+	nk_love_preserve(L, &context->nkctx.style.property.dec_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.property.dec_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.property.dec_button.active);
+
+	nk_love_preserve(L, &context->nkctx.style.edit.normal);
+	nk_love_preserve(L, &context->nkctx.style.edit.hover);
+	nk_love_preserve(L, &context->nkctx.style.edit.active);
+	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.normal);
+	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.hover);
+	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.active);
+	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.cursor_normal);
+	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.cursor_hover);
+	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.cursor_active);
+
+	nk_love_preserve(L, &context->nkctx.style.chart.background);
+
+	nk_love_preserve(L, &context->nkctx.style.scrollh.normal);
+	nk_love_preserve(L, &context->nkctx.style.scrollh.hover);
+	nk_love_preserve(L, &context->nkctx.style.scrollh.active);
+	nk_love_preserve(L, &context->nkctx.style.scrollh.cursor_normal);
+	nk_love_preserve(L, &context->nkctx.style.scrollh.cursor_hover);
+	nk_love_preserve(L, &context->nkctx.style.scrollh.cursor_active);
+
+	nk_love_preserve(L, &context->nkctx.style.scrollv.normal);
+	nk_love_preserve(L, &context->nkctx.style.scrollv.hover);
+	nk_love_preserve(L, &context->nkctx.style.scrollv.active);
+	nk_love_preserve(L, &context->nkctx.style.scrollv.cursor_normal);
+	nk_love_preserve(L, &context->nkctx.style.scrollv.cursor_hover);
+	nk_love_preserve(L, &context->nkctx.style.scrollv.cursor_active);
+
+	nk_love_preserve(L, &context->nkctx.style.tab.background);
+	nk_love_preserve(L, &context->nkctx.style.tab.tab_maximize_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.tab.tab_maximize_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.tab.tab_maximize_button.active);
+	nk_love_preserve(L, &context->nkctx.style.tab.tab_minimize_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.tab.tab_minimize_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.tab.tab_minimize_button.active);
+	nk_love_preserve(L, &context->nkctx.style.tab.node_maximize_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.tab.node_maximize_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.tab.node_maximize_button.active);
+	nk_love_preserve(L, &context->nkctx.style.tab.node_minimize_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.tab.node_minimize_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.tab.node_minimize_button.active);
+
+	nk_love_preserve(L, &context->nkctx.style.combo.normal);
+	nk_love_preserve(L, &context->nkctx.style.combo.hover);
+	nk_love_preserve(L, &context->nkctx.style.combo.active);
+	nk_love_preserve(L, &context->nkctx.style.combo.button.normal);
+	nk_love_preserve(L, &context->nkctx.style.combo.button.hover);
+	nk_love_preserve(L, &context->nkctx.style.combo.button.active);
+
+	nk_love_preserve(L, &context->nkctx.style.window.fixed_background);
+	nk_love_preserve(L, &context->nkctx.style.window.scaler);
+	nk_love_preserve(L, &context->nkctx.style.window.header.normal);
+	nk_love_preserve(L, &context->nkctx.style.window.header.hover);
+	nk_love_preserve(L, &context->nkctx.style.window.header.active);
+	nk_love_preserve(L, &context->nkctx.style.window.header.close_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.window.header.close_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.window.header.close_button.active);
+	nk_love_preserve(L, &context->nkctx.style.window.header.minimize_button.normal);
+	nk_love_preserve(L, &context->nkctx.style.window.header.minimize_button.hover);
+	nk_love_preserve(L, &context->nkctx.style.window.header.minimize_button.active);
+	context->style_scan = context->style_generation;
+}
+
+static int nk_love_frame_begin(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert(L, context == NULL, "%s: missing ui:frameEnd for previous frame");
+	context = nk_love_checkcontext(L, 1);
+	nk_input_end(&context->nkctx);
+	memset(&context->stats, 0, sizeof(context->stats));
+	context->heap_start = nk_love_heap_size(L);
+	lua_getglobal(L, "love");
+	lua_getfield(L, -1, "timer");
+	lua_getfield(L, -1, "getDelta");
+	lua_call(L, 0, 1);
+	float dt = lua_tonumber(L, -1);
+	context->nkctx.delta_time_seconds = dt;
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_pushlightuserdata(L, context);
+	lua_gettable(L, -2);
+	context->frame++;
+	if (context->style_scan != context->style_generation)
+		nk_love_preserve_all(L);
+	context->style_frame_depth = context->style_depth;
+	nk_love_release_images(L);
+	((struct nk_love_font *) context->nkctx.style.font)->frame = context->frame;
+	int i;
+	for (i = 0; i < context->style_save_count; ++i) {
+		struct nk_love_style_entry *save = &context->style_saves[i];
+		if (save->kind == NK_LOVE_STYLE_FONT)
+			((struct nk_love_font *) save->value.font)->frame = context->frame;
+	}
+	nk_love_release_fonts(L);
+	nk_love_arena_reset(&context->arena);
+	for (i = 0; i < 9; ++i)
+		context->T[i] = context->Ti[i] = (i % 3 == i / 3);
+	context->transform_count = 0;
+	context->transform_allowed = 1;
+	context->list_view_count = 0;
+	context->pen_count = 0;
+	context->pen_font = NULL;
+	if (context->pen_sync)
+		nk_love_sync_pen(L);
+	return 0;
+}
+
+static int nk_love_frame_end(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	if (context->style_depth > context->style_frame_depth)
+		context->style_generation++;
+	nk_input_begin(&context->nkctx);
+	context = NULL;
+	return 0;
+}
+
+static int nk_love_frame(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	if (!lua_isfunction(L, -1))
+		luaL_typerror(L, lua_gettop(L), "function");
+	lua_getfield(L, 1, "frameBegin");
+	lua_pushvalue(L, 1);
+	lua_call(L, 1, 0);
+	lua_pushvalue(L, 1);
+	lua_call(L, 1, 0);
+	lua_getfield(L, 1, "frameEnd");
+	lua_insert(L, 1);
+	lua_call(L, 1, 0);
+	return 0;
+}
+
+/*
+ * ===============================================================
+ *
+ *                          TRANSFORM
+ *
+ * ===============================================================
+ */
+
+/*
+cos -sin  0 |  cos  sin  0
+sin  cos  0 | -sin  cos  0
+0    0    1 |  0    0    1
+*/
+static void nk_love_push_transform(lua_State *L, enum nk_love_graphics_function function,
+	int argc, float x, float y)
+{
+	nk_love_assert(L, context->transform_count < NK_LOVE_MAX_TRANSFORMS,
+		"%s: too many UI transformations");
+	struct nk_love_transform *transform = &context->transforms[context->transform_count++];
+	transform->function = function;
+	transform->argc = argc;
+	transform->args[0] = x;
+	transform->args[1] = y;
+}
+
+static int nk_love_rotate(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_transform(L);
+	float angle = luaL_checknumber(L, 2);
+	nk_love_push_transform(L, NK_LOVE_GRAPHICS_ROTATE, 1, angle, 0);
+	float *T = context->T, *Ti = context->Ti;
+	float c = cosf(angle);
+	float s = sinf(angle);
+	int i;
+	float R[9];
+	R[0] = T[0] * c + T[3] * s;
+	R[1] = T[1] * c + T[4] * s;
+	R[2] = T[2] * c + T[5] * s;
+	R[3] = T[0] * -s + T[3] * c;
+	R[4] = T[1] * -s + T[4] * c;
+	R[5] = T[2] * -s + T[5] * c;
+	R[6] = T[6];
+	R[7] = T[7];
+	R[8] = T[8];
+	for (i = 0; i < 9; ++i)
+		T[i] = R[i];
+	R[0] = c * Ti[0] + s * Ti[1];
+	R[1] = -s * Ti[0] + c * Ti[1];
+	R[2] = Ti[2];
+	R[3] = c * Ti[3] + s * Ti[4];
+	R[4] = -s * Ti[3] + c * Ti[4];
+	R[5] = Ti[5];
+	R[6] = c * Ti[6] + s * Ti[7];
+	R[7] = -s * Ti[6] + c * Ti[7];
+	R[8] = Ti[8];
+	for (i = 0; i < 9; ++i)
+		Ti[i] = R[i];
+	return 0;
+}
+
+/*
+sx 0  0 | 1/sx 0    0
+0  sy 0 | 0    1/sy 0
+0  0  1 | 0    0    1
+*/
+static int nk_love_scale(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 2 && lua_gettop(L) <= 3);
+	nk_love_assert_transform(L);
+	float sx = luaL_checknumber(L, 2);
+	float sy = luaL_optnumber(L, 3, sx);
+	nk_love_push_transform(L, NK_LOVE_GRAPHICS_SCALE, 2, sx, sy);
+	float *T = context->T, *Ti = context->Ti;
+	T[0] *= sx;
+	T[1] *= sx;
+	T[2] *= sx;
+	T[3] *= sy;
+	T[4] *= sy;
+	T[5] *= sy;
+	Ti[0] /= sx;
+	Ti[1] /= sy;
+	Ti[3] /= sx;
+	Ti[4] /= sy;
+	Ti[6] /= sx;
+	Ti[7] /= sy;
+	return 0;
+}
+
+/*
+1  kx 0 | 1/(1-kx*ky)  kx/(kx*ky-1) 0
+ky 1  0 | ky/(kx*ky-1) 1/(1-kx*ky)  0
+0  0  1 | 0            0            1
+*/
+static int nk_love_shear(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	nk_love_assert_transform(L);
+	float kx = luaL_checknumber(L, 2);
+	float ky = luaL_checknumber(L, 3);
+	nk_love_push_transform(L, NK_LOVE_GRAPHICS_SHEAR, 2, kx, ky);
+	float *T = context->T, *Ti = context->Ti;
+	float R[9];
+	R[0] = T[0] + T[3] * ky;
+	R[1] = T[1] + T[4] * ky;
+	R[2] = T[2] + T[5] * ky;
+	R[3] = T[0] * kx + T[3];
+	R[4] = T[1] * kx + T[4];
+	R[5] = T[2] * kx + T[5];
+	R[6] = T[6];
+	R[7] = T[7];
+	R[8] = T[8];
+	int i;
+	for (i = 0; i < 9; ++i)
+		T[i] = R[i];
+	float a = 1.0f / (1 - kx * ky);
+	float b = 1.0f / (kx * ky - 1);
+	R[0] = a * Ti[0] + kx * b * Ti[1];
+	R[1] = ky * b * Ti[0] + a * Ti[1];
+	R[2] = Ti[2];
+	R[3] = a * Ti[3] + kx * b * Ti[4];
+	R[4] = ky * b * Ti[3] + a * Ti[4];
+	R[5] = Ti[5];
+	R[6] = a * Ti[6] + kx * b * Ti[7];
+	R[7] = ky * b * Ti[6] + a * Ti[7];
+	R[8] = Ti[8];
+	for (i = 0; i < 9; ++i)
+		Ti[i] = R[i];
+	return 0;
+}
+
+/*
+1 0 dx | 1 0 -dx
+0 1 dy | 0 1 -dy
+0 0 1  | 0 0  1
+*/
+static int nk_love_translate(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	nk_love_assert_transform(L);
+	float dx = luaL_checknumber(L, 2);
+	float dy = luaL_checknumber(L, 3);
+	nk_love_push_transform(L, NK_LOVE_GRAPHICS_TRANSLATE, 2, dx, dy);
+	float *T = context->T, *Ti = context->Ti;
+	float R[9];
+	T[6] += T[0] * dx + T[3] * dy;
+	T[7] += T[1] * dx + T[4] * dy;
+	T[8] += T[2] * dx + T[5] * dy;
+	R[0] = Ti[0] - dx * Ti[2];
+	R[1] = Ti[1] - dy * Ti[2];
+	R[2] = Ti[2];
+	R[3] = Ti[3] - dx * Ti[5];
+	R[4] = Ti[4] - dy * Ti[5];
+	R[5] = Ti[5];
+	R[6] = Ti[6] - dx * Ti[8];
+	R[7] = Ti[7] - dy * Ti[8];
+	R[8] = Ti[8];
+	int i;
+	for (i = 0; i < 9; ++i)
+		Ti[i] = R[i];
+	return 0;
+}
+
+/*
+ * ===============================================================
+ *
+ *                          WINDOW
+ *
+ * ===============================================================
+ */
+
+static int nk_love_window_begin(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 1);
+	nk_love_assert_context(L, 1);
+	const char *name, *title;
+	int bounds_begin;
+	if (lua_isnumber(L, 3)) {
+		nk_love_assert_argc(L, lua_gettop(L) >= 6);
+		name = title = luaL_checkstring(L, 2);
+		bounds_begin = 3;
+	} else {
+		nk_love_assert_argc(L, lua_gettop(L) >= 7);
+		name = luaL_checkstring(L, 2);
+		title = luaL_checkstring(L, 3);
+		bounds_begin = 4;
+	}
+	nk_flags flags = nk_love_parse_window_flags(L, bounds_begin + 4, lua_gettop(L));
+	float x = luaL_checknumber(L, bounds_begin);
+	float y = luaL_checknumber(L, bounds_begin + 1);
+	float width = luaL_checknumber(L, bounds_begin + 2);
+	float height = luaL_checknumber(L, bounds_begin + 3);
+	int open = nk_begin_titled(&context->nkctx, name, title, nk_rect(x, y, width, height), flags);
+	lua_pushboolean(L, open);
+	return 1;
+}
+
+static int nk_love_window_end(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	nk_end(&context->nkctx);
+	return 0;
+}
+
+static int nk_love_window(lua_State *L)
+{
+	nk_love_assert(L, lua_checkstack(L, 2), "%s: failed to allocate stack space");
+	if (!lua_isfunction(L, -1))
+		luaL_typerror(L, lua_gettop(L), "function");
+	lua_insert(L, 2);
+	lua_pushvalue(L, 1);
+	lua_insert(L, 3);
+	lua_getfield(L, 1, "windowBegin");
+	lua_insert(L, 3);
+	lua_call(L, lua_gettop(L) - 3, 1);
+	int open = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+	if (open) {
+		lua_pushvalue(L, 1);
+		lua_call(L, 1, 0);
+	} else {
+		lua_pop(L, 1);
+	}
+	lua_getfield(L, -1, "windowEnd");
+	lua_insert(L, 1);
+	lua_call(L, 1, 0);
+	return 0;
+}
+
+static int nk_love_window_get_bounds(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	struct nk_rect rect = nk_window_get_bounds(&context->nkctx);
+	lua_pushnumber(L, rect.x);
+	lua_pushnumber(L, rect.y);
+	lua_pushnumber(L, rect.w);
+	lua_pushnumber(L, rect.h);
+	return 4;
+}
+
+static int nk_love_window_get_position(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	struct nk_vec2 pos = nk_window_get_position(&context->nkctx);
+	lua_pushnumber(L, pos.x);
+	lua_pushnumber(L, pos.y);
+	return 2;
+}
+
+static int nk_love_window_get_size(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	struct nk_vec2 size = nk_window_get_size(&context->nkctx);
+	lua_pushnumber(L, size.x);
+	lua_pushnumber(L, size.y);
+	return 2;
+}
+
+static int nk_love_window_get_scroll(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	nk_uint offset_x, offset_y;
+	nk_window_get_scroll(&context->nkctx, &offset_x, &offset_y);
+	lua_pushinteger(L, offset_x);
+	lua_pushinteger(L, offset_y);
+	return 2;
+}
+
+static int nk_love_window_get_content_region(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	struct nk_rect rect = nk_window_get_content_region(&context->nkctx);
+	lua_pushnumber(L, rect.x);
+	lua_pushnumber(L, rect.y);
+	lua_pushnumber(L, rect.w);
+	lua_pushnumber(L, rect.h);
+	return 4;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.edit.normal);
-	nk_love_preserve(L, &context->nkctx.style.edit.hover);
-	nk_love_preserve(L, &context->nkctx.style.edit.active);
-	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.normal);
-	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.hover);
-	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.active);
-	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.cursor_normal);
-	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.cursor_hover);
-	nk_love_preserve(L, &context->nkctx.style.edit.scrollbar.cursor_active);
+static int nk_love_window_has_focus(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	int has_focus = nk_window_has_focus(&context->nkctx);
+	lua_pushboolean(L, has_focus);
+	return 1;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.chart.background);
+static int nk_love_window_is_collapsed(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	int is_collapsed = nk_window_is_collapsed(&context->nkctx, name);
+	lua_pushboolean(L, is_collapsed);
+	return 1;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.scrollh.normal);
-	nk_love_preserve(L, &context->nkctx.style.scrollh.hover);
-	nk_love_preserve(L, &context->nkctx.style.scrollh.active);
-	nk_love_preserve(L, &context->nkctx.style.scrollh.cursor_normal);
-	nk_love_preserve(L, &context->nkctx.style.scrollh.cursor_hover);
-	nk_love_preserve(L, &context->nkctx.style.scrollh.cursor_active);
+static int nk_love_window_is_closed(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	int is_closed = nk_window_is_closed(&context->nkctx, name);
+	lua_pushboolean(L, is_closed);
+	return 1;
+}
+
+static int nk_love_window_is_hidden(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	int is_hidden = nk_window_is_hidden(&context->nkctx, name);
+	lua_pushboolean(L, is_hidden);
+	return 1;
+}
+
+static int nk_love_window_is_active(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	int is_active = nk_window_is_active(&context->nkctx, name);
+	lua_pushboolean(L, is_active);
+	return 1;
+}
+
+static int nk_love_window_is_hovered(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	int is_hovered = nk_window_is_hovered(&context->nkctx);
+	lua_pushboolean(L, is_hovered);
+	return 1;
+}
+
+static int nk_love_window_is_any_hovered(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	int is_any_hovered = nk_window_is_any_hovered(&context->nkctx);
+	lua_pushboolean(L, is_any_hovered);
+	return 1;
+}
+
+static int nk_love_item_is_any_active(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	lua_pushboolean(L, nk_love_is_active(&context->nkctx));
+	return 1;
+}
+
+static int nk_love_window_set_bounds(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 6);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	struct nk_rect bounds;
+	bounds.x = luaL_checknumber(L, 3);
+	bounds.y = luaL_checknumber(L, 4);
+	bounds.w = luaL_checknumber(L, 5);
+	bounds.h = luaL_checknumber(L, 6);
+	nk_window_set_bounds(&context->nkctx, name, bounds);
+	return 0;
+}
+
+static int nk_love_window_set_position(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 4);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	struct nk_vec2 pos;
+	pos.x = luaL_checknumber(L, 3);
+	pos.y = luaL_checknumber(L, 4);
+	nk_window_set_position(&context->nkctx, name, pos);
+	return 0;
+}
+
+static int nk_love_window_set_size(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 4);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	struct nk_vec2 size;
+	size.x = luaL_checknumber(L, 3);
+	size.y = luaL_checknumber(L, 4);
+	nk_window_set_size(&context->nkctx, name, size);
+	return 0;
+}
+
+static int nk_love_window_set_focus(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	nk_window_set_focus(&context->nkctx, name);
+	return 0;
+}
+
+static int nk_love_window_set_scroll(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	nk_love_assert_context(L, 1);
+	nk_uint offset_x, offset_y;
+	offset_x = luaL_checkinteger(L, 2);
+	offset_y = luaL_checkinteger(L, 3);
+	nk_window_set_scroll(&context->nkctx, offset_x, offset_y);
+	return 0;
+}
+
+static int nk_love_window_close(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	nk_window_close(&context->nkctx, name);
+	return 0;
+}
+
+static int nk_love_window_collapse(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	nk_window_collapse(&context->nkctx, name, NK_MINIMIZED);
+	return 0;
+}
+
+static int nk_love_window_expand(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	nk_window_collapse(&context->nkctx, name, NK_MAXIMIZED);
+	return 0;
+}
+
+static int nk_love_window_show(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	nk_window_show(&context->nkctx, name, NK_SHOWN);
+	return 0;
+}
+
+static int nk_love_window_hide(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	const char *name = luaL_checkstring(L, 2);
+	nk_window_show(&context->nkctx, name, NK_HIDDEN);
+	return 0;
+}
+
+/*
+ * ===============================================================
+ *
+ *                           LAYOUT
+ *
+ * ===============================================================
+ */
+
+static int nk_love_layout_row(lua_State *L)
+{
+	int argc = lua_gettop(L);
+	if (argc == 5 && lua_isfunction(L, 5)) {
+		nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
+		lua_pushvalue(L, 1);
+		lua_insert(L, 2);
+		lua_pushvalue(L, 1);
+		lua_insert(L, 3);
+		lua_insert(L, 2);
+		lua_getfield(L, 1, "layoutRowBegin");
+		lua_insert(L, 4);
+		lua_call(L, 4, 0);
+		lua_call(L, 1, 0);
+		lua_getfield(L, 1, "layoutRowEnd");
+		lua_insert(L, 1);
+		lua_call(L, 1, 0);
+	} else {
+		nk_love_assert_argc(L, argc >= 4 && argc <= 5);
+		nk_love_assert_context(L, 1);
+		enum nk_layout_format format = nk_love_checkformat(L, 2);
+		float height = luaL_checknumber(L, 3);
+		int use_ratios = 0;
+		if (format == NK_DYNAMIC) {
+			nk_love_assert_argc(L, argc == 4);
+			if (lua_isnumber(L, 4)) {
+				int cols = luaL_checkint(L, 4);
+				nk_layout_row_dynamic(&context->nkctx, height, cols);
+			} else {
+				if (!lua_istable(L, 4))
+					luaL_argerror(L, 4, "should be a number or table");
+				use_ratios = 1;
+			}
+		} else if (format == NK_STATIC) {
+			if (argc == 5) {
+				int item_width = luaL_checkint(L, 4);
+				int cols = luaL_checkint(L, 5);
+				nk_layout_row_static(&context->nkctx, height, item_width, cols);
+			} else {
+				if (!lua_istable(L, 4))
+					luaL_argerror(L, 4, "should be a number or table");
+				use_ratios = 1;
+			}
+		}
+		if (use_ratios) {
+			int cols = lua_objlen(L, -1);
+			float *ratios = nk_love_arena_alloc(L, sizeof(float) * cols);
+			int i;
+			for (i = 0; i < cols; ++i) {
+				lua_rawgeti(L, -1, i + 1);
+				if (!lua_isnumber(L, -1))
+					luaL_argerror(L, lua_gettop(L) - 1, "should contain numbers only");
+				ratios[i] = lua_tonumber(L, -1);
+				lua_pop(L, 1);
+			}
+			nk_layout_row(&context->nkctx, format, height, cols, ratios);
+		}
+	}
+	return 0;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.scrollv.normal);
-	nk_love_preserve(L, &context->nkctx.style.scrollv.hover);
-	nk_love_preserve(L, &context->nkctx.style.scrollv.active);
-	nk_love_preserve(L, &context->nkctx.style.scrollv.cursor_normal);
-	nk_love_preserve(L, &context->nkctx.style.scrollv.cursor_hover);
-	nk_love_preserve(L, &context->nkctx.style.scrollv.cursor_active);
+static int nk_love_layout_row_begin(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 4);
+	nk_love_assert_context(L, 1);
+	enum nk_layout_format format = nk_love_checkformat(L, 2);
+	float height = luaL_checknumber(L, 3);
+	int cols = luaL_checkint(L, 4);
+	nk_layout_row_begin(&context->nkctx, format, height, cols);
+	return 0;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.tab.background);
-	nk_love_preserve(L, &context->nkctx.style.tab.tab_maximize_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.tab.tab_maximize_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.tab.tab_maximize_button.active);
-	nk_love_preserve(L, &context->nkctx.style.tab.tab_minimize_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.tab.tab_minimize_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.tab.tab_minimize_button.active);
-	nk_love_preserve(L, &context->nkctx.style.tab.node_maximize_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.tab.node_maximize_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.tab.node_maximize_button.active);
-	nk_love_preserve(L, &context->nkctx.style.tab.node_minimize_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.tab.node_minimize_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.tab.node_minimize_button.active);
+static int nk_love_layout_row_push(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	float value = luaL_checknumber(L, 2);
+	nk_layout_row_push(&context->nkctx, value);
+	return 0;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.combo.normal);
-	nk_love_preserve(L, &context->nkctx.style.combo.hover);
-	nk_love_preserve(L, &context->nkctx.style.combo.active);
-	nk_love_preserve(L, &context->nkctx.style.combo.button.normal);
-	nk_love_preserve(L, &context->nkctx.style.combo.button.hover);
-	nk_love_preserve(L, &context->nkctx.style.combo.button.active);
+static int nk_love_layout_row_end(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	nk_layout_row_end(&context->nkctx);
+	return 0;
+}
 
-	nk_love_preserve(L, &context->nkctx.style.window.fixed_background);
-	nk_love_preserve(L, &context->nkctx.style.window.scaler);
-	nk_love_preserve(L, &context->nkctx.style.window.header.normal);
-	nk_love_preserve(L, &context->nkctx.style.window.header.hover);
-	nk_love_preserve(L, &context->nkctx.style.window.header.active);
-	nk_love_preserve(L, &context->nkctx.style.window.header.close_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.window.header.close_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.window.header.close_button.active);
-	nk_love_preserve(L, &context->nkctx.style.window.header.minimize_button.normal);
-	nk_love_preserve(L, &context->nkctx.style.window.header.minimize_button.hover);
-	nk_love_preserve(L, &context->nkctx.style.window.header.minimize_button.active);
+static int nk_love_layout_template_begin(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	float height = luaL_checknumber(L, 2);
+	nk_layout_row_template_begin(&context->nkctx, height);
+	return 0;
 }
 
-static int nk_love_frame_begin(lua_State *L)
+static int nk_love_layout_template_push(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert(L, context == NULL, "%s: missing ui:frameEnd for previous frame");
-	context = nk_love_checkcontext(L, 1);
-	nk_input_end(&context->nkctx);
-	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "timer");
-	lua_getfield(L, -1, "getDelta");
-	lua_call(L, 0, 1);
-	float dt = lua_tonumber(L, -1);
-	context->nkctx.delta_time_seconds = dt;
-	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
-	lua_pushlightuserdata(L, context);
-	lua_gettable(L, -2);
-	lua_getfield(L, -1, "image");
-	lua_newtable(L);
-	lua_setfield(L, -3, "image");
-	nk_love_preserve_all(L);
-	lua_pop(L, 1);
-	lua_getfield(L, -1, "font");
-	lua_newtable(L);
-	lua_setfield(L, -3, "font");
-	context->font_count = 0;
-	struct nk_love_handle *love_handle = context->nkctx.style.font->userdata.ptr;
-	lua_rawgeti(L, -1, love_handle->ref);
-	nk_love_checkFont(L, -1, &context->fonts[context->font_count]);
-	lua_pop(L, 1);
-	context->nkctx.style.font = &context->fonts[context->font_count++].font;
-	int i;
-	for (i = 0; i < context->nkctx.stacks.fonts.head; ++i) {
-		struct nk_config_stack_user_font_element *element = &context->nkctx.stacks.fonts.elements[i];
-		love_handle = element->old_value->userdata.ptr;
-		lua_rawgeti(L, -1, love_handle->ref);
-		nk_love_checkFont(L, -1, &context->fonts[context->font_count]);
-		lua_pop(L, 1);
-		context->nkctx.stacks.fonts.elements[i].old_value = &context->fonts[context->font_count++].font;
+	nk_love_assert_argc(L, lua_gettop(L) == 2 || lua_gettop(L) == 3);
+	nk_love_assert_context(L, 1);
+	const char *mode = luaL_checkstring(L, 2);
+	if (!strcmp(mode, "dynamic")) {
+		nk_love_assert_argc(L, lua_gettop(L) == 2);
+		nk_layout_row_template_push_dynamic(&context->nkctx);
+	} else {
+		nk_love_assert_argc(L, lua_gettop(L) == 3);
+		float width = luaL_checknumber(L, 3);
+		if (!strcmp(mode, "variable")) {
+			nk_layout_row_template_push_variable(&context->nkctx, width);
+		} else if (!strcmp(mode, "static")) {
+			nk_layout_row_template_push_static(&context->nkctx, width);
+		} else {
+			return luaL_argerror(L, 2, "expecting 'dynamic', 'variable', or 'static' modes");
+		}
 	}
-	lua_pop(L, 1);
-	context->layout_ratio_count = 0;
-	for (i = 0; i < 9; ++i)
-		context->T[i] = context->Ti[i] = (i % 3 == i / 3);
-	context->transform_allowed = 1;
-	lua_newtable(L);
-	lua_setfield(L, -2, "transform");
 	return 0;
 }
 
-static int nk_love_frame_end(lua_State *L)
+static int nk_love_layout_template_end(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
 	nk_love_assert_context(L, 1);
-	nk_input_begin(&context->nkctx);
-	context = NULL;
+	nk_layout_row_template_end(&context->nkctx);
 	return 0;
 }
 
-static int nk_love_frame(lua_State *L)
+static int nk_love_layout_template(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
 	if (!lua_isfunction(L, -1))
 		luaL_typerror(L, lua_gettop(L), "function");
-	lua_getfield(L, 1, "frameBegin");
 	lua_pushvalue(L, 1);
-	lua_call(L, 1, 0);
+	lua_insert(L, 2);
 	lua_pushvalue(L, 1);
+	lua_insert(L, 3);
+	lua_insert(L, 2);
+	lua_getfield(L, 1, "layoutTemplateBegin");
+	lua_insert(L, 4);
+	lua_call(L, 2, 0);
 	lua_call(L, 1, 0);
-	lua_getfield(L, 1, "frameEnd");
+	lua_getfield(L, 1, "layoutTemplateEnd");
 	lua_insert(L, 1);
 	lua_call(L, 1, 0);
 	return 0;
 }
 
-/*
- * ===============================================================
- *
- *                          TRANSFORM
- *
- * ===============================================================
- */
+static int nk_love_layout_space_begin(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 4);
+	nk_love_assert_context(L, 1);
+	enum nk_layout_format format = nk_love_checkformat(L, 2);
+	float height = luaL_checknumber(L, 3);
+	int widget_count = luaL_checkint(L, 4);
+	nk_layout_space_begin(&context->nkctx, format, height, widget_count);
+	return 0;
+}
 
-/*
-cos -sin  0 |  cos  sin  0
-sin  cos  0 | -sin  cos  0
-0    0    1 |  0    0    1
-*/
-static int nk_love_rotate(lua_State *L)
+static int nk_love_layout_space_push(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_transform(L);
-	float angle = luaL_checknumber(L, 2);
-	nk_love_pushregistry(L, "transform");
-	size_t len = lua_objlen(L, -1);
-	lua_newtable(L);
-	lua_pushstring(L, "rotate");
-	lua_rawseti(L, -2, 1);
-	lua_pushnumber(L, angle);
-	lua_rawseti(L, -2, 2);
-	lua_rawseti(L, -2, len + 1);
-	float *T = context->T, *Ti = context->Ti;
-	float c = cosf(angle);
-	float s = sinf(angle);
-	int i;
-	float R[9];
-	R[0] = T[0] * c + T[3] * s;
-	R[1] = T[1] * c + T[4] * s;
-	R[2] = T[2] * c + T[5] * s;
-	R[3] = T[0] * -s + T[3] * c;
-	R[4] = T[1] * -s + T[4] * c;
-	R[5] = T[2] * -s + T[5] * c;
-	R[6] = T[6];
-	R[7] = T[7];
-	R[8] = T[8];
-	for (i = 0; i < 9; ++i)
-		T[i] = R[i];
-	R[0] = c * Ti[0] + s * Ti[1];
-	R[1] = -s * Ti[0] + c * Ti[1];
-	R[2] = Ti[2];
-	R[3] = c * Ti[3] + s * Ti[4];
-	R[4] = -s * Ti[3] + c * Ti[4];
-	R[5] = Ti[5];
-	R[6] = c * Ti[6] + s * Ti[7];
-	R[7] = -s * Ti[6] + c * Ti[7];
-	R[8] = Ti[8];
-	for (i = 0; i < 9; ++i)
-		Ti[i] = R[i];
+	nk_love_assert_argc(L, lua_gettop(L) == 5);
+	nk_love_assert_context(L, 1);
+	float x = luaL_checknumber(L, 2);
+	float y = luaL_checknumber(L, 3);
+	float width = luaL_checknumber(L, 4);
+	float height = luaL_checknumber(L, 5);
+	nk_layout_space_push(&context->nkctx, nk_rect(x, y, width, height));
 	return 0;
 }
 
-/*
-sx 0  0 | 1/sx 0    0
-0  sy 0 | 0    1/sy 0
-0  0  1 | 0    0    1
-*/
-static int nk_love_scale(lua_State *L)
+static int nk_love_layout_space_end(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) >= 2 && lua_gettop(L) <= 3);
-	nk_love_assert_transform(L);
-	float sx = luaL_checknumber(L, 2);
-	float sy = luaL_optnumber(L, 3, sx);
-	nk_love_pushregistry(L, "transform");
-	size_t len = lua_objlen(L, -1);
-	lua_newtable(L);
-	lua_pushstring(L, "scale");
-	lua_rawseti(L, -2, 1);
-	lua_pushnumber(L, sx);
-	lua_rawseti(L, -2, 2);
-	lua_pushnumber(L, sy);
-	lua_rawseti(L, -2, 3);
-	lua_rawseti(L, -2, len + 1);
-	float *T = context->T, *Ti = context->Ti;
-	T[0] *= sx;
-	T[1] *= sx;
-	T[2] *= sx;
-	T[3] *= sy;
-	T[4] *= sy;
-	T[5] *= sy;
-	Ti[0] /= sx;
-	Ti[1] /= sy;
-	Ti[3] /= sx;
-	Ti[4] /= sy;
-	Ti[6] /= sx;
-	Ti[7] /= sy;
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	nk_layout_space_end(&context->nkctx);
+	return 0;
+}
+
+static int nk_love_layout_space(lua_State *L)
+{
+	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
+	nk_love_assert_argc(L, lua_gettop(L) == 5);
+	if (!lua_isfunction(L, -1))
+		luaL_typerror(L, lua_gettop(L), "function");
+	lua_pushvalue(L, 1);
+	lua_insert(L, 2);
+	lua_pushvalue(L, 1);
+	lua_insert(L, 3);
+	lua_insert(L, 2);
+	lua_getfield(L, 1, "layoutSpaceBegin");
+	lua_insert(L, 4);
+	lua_call(L, 4, 0);
+	lua_call(L, 1, 0);
+	lua_getfield(L, 1, "layoutSpaceEnd");
+	lua_insert(L, 1);
+	lua_call(L, 1, 0);
 	return 0;
 }
 
-/*
-1  kx 0 | 1/(1-kx*ky)  kx/(kx*ky-1) 0
-ky 1  0 | ky/(kx*ky-1) 1/(1-kx*ky)  0
-0  0  1 | 0            0            1
-*/
-static int nk_love_shear(lua_State *L)
+static int nk_love_layout_space_bounds(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	struct nk_rect bounds = nk_layout_space_bounds(&context->nkctx);
+	lua_pushnumber(L, bounds.x);
+	lua_pushnumber(L, bounds.y);
+	lua_pushnumber(L, bounds.w);
+	lua_pushnumber(L, bounds.h);
+	return 4;
+}
+
+static int nk_love_layout_space_to_screen(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 3);
-	nk_love_assert_transform(L);
-	float kx = luaL_checknumber(L, 2);
-	float ky = luaL_checknumber(L, 3);
-	nk_love_pushregistry(L, "transform");
-	size_t len = lua_objlen(L, -1);
-	lua_newtable(L);
-	lua_pushstring(L, "shear");
-	lua_rawseti(L, -2, 1);
-	lua_pushnumber(L, kx);
-	lua_rawseti(L, -2, 2);
-	lua_pushnumber(L, ky);
-	lua_rawseti(L, -2, 3);
-	lua_rawseti(L, -2, len + 1);
-	float *T = context->T, *Ti = context->Ti;
-	float R[9];
-	R[0] = T[0] + T[3] * ky;
-	R[1] = T[1] + T[4] * ky;
-	R[2] = T[2] + T[5] * ky;
-	R[3] = T[0] * kx + T[3];
-	R[4] = T[1] * kx + T[4];
-	R[5] = T[2] * kx + T[5];
-	R[6] = T[6];
-	R[7] = T[7];
-	R[8] = T[8];
-	int i;
-	for (i = 0; i < 9; ++i)
-		T[i] = R[i];
-	float a = 1.0f / (1 - kx * ky);
-	float b = 1.0f / (kx * ky - 1);
-	R[0] = a * Ti[0] + kx * b * Ti[1];
-	R[1] = ky * b * Ti[0] + a * Ti[1];
-	R[2] = Ti[2];
-	R[3] = a * Ti[3] + kx * b * Ti[4];
-	R[4] = ky * b * Ti[3] + a * Ti[4];
-	R[5] = Ti[5];
-	R[6] = a * Ti[6] + kx * b * Ti[7];
-	R[7] = ky * b * Ti[6] + a * Ti[7];
-	R[8] = Ti[8];
-	for (i = 0; i < 9; ++i)
-		Ti[i] = R[i];
-	return 0;
+	nk_love_assert_context(L, 1);
+	struct nk_vec2 local;
+	local.x = luaL_checknumber(L, 2);
+	local.y = luaL_checknumber(L, 3);
+	struct nk_vec2 screen = nk_layout_space_to_screen(&context->nkctx, local);
+	lua_pushnumber(L, screen.x);
+	lua_pushnumber(L, screen.y);
+	return 2;
 }
 
-/*
-1 0 dx | 1 0 -dx
-0 1 dy | 0 1 -dy
-0 0 1  | 0 0  1
-*/
-static int nk_love_translate(lua_State *L)
+static int nk_love_layout_space_to_local(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 3);
-	nk_love_assert_transform(L);
-	float dx = luaL_checknumber(L, 2);
-	float dy = luaL_checknumber(L, 3);
-	nk_love_pushregistry(L, "transform");
-	size_t len = lua_objlen(L, -1);
-	lua_newtable(L);
-	lua_pushstring(L, "translate");
-	lua_rawseti(L, -2, 1);
-	lua_pushnumber(L, dx);
-	lua_rawseti(L, -2, 2);
-	lua_pushnumber(L, dy);
-	lua_rawseti(L, -2, 3);
-	lua_rawseti(L, -2, len + 1);
-	float *T = context->T, *Ti = context->Ti;
-	float R[9];
-	T[6] += T[0] * dx + T[3] * dy;
-	T[7] += T[1] * dx + T[4] * dy;
-	T[8] += T[2] * dx + T[5] * dy;
-	R[0] = Ti[0] - dx * Ti[2];
-	R[1] = Ti[1] - dy * Ti[2];
-	R[2] = Ti[2];
-	R[3] = Ti[3] - dx * Ti[5];
-	R[4] = Ti[4] - dy * Ti[5];
-	R[5] = Ti[5];
-	R[6] = Ti[6] - dx * Ti[8];
-	R[7] = Ti[7] - dy * Ti[8];
-	R[8] = Ti[8];
-	int i;
-	for (i = 0; i < 9; ++i)
-		Ti[i] = R[i];
-	return 0;
+	nk_love_assert_context(L, 1);
+	struct nk_vec2 screen;
+	screen.x = luaL_checknumber(L, 2);
+	screen.y = luaL_checknumber(L, 3);
+	struct nk_vec2 local = nk_layout_space_to_local(&context->nkctx, screen);
+	lua_pushnumber(L, local.x);
+	lua_pushnumber(L, local.y);
+	return 2;
+}
+
+static int nk_love_layout_space_rect_to_screen(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 5);
+	nk_love_assert_context(L, 1);
+	struct nk_rect local;
+	local.x = luaL_checknumber(L, 2);
+	local.y = luaL_checknumber(L, 3);
+	local.w = luaL_checknumber(L, 4);
+	local.h = luaL_checknumber(L, 5);
+	struct nk_rect screen = nk_layout_space_rect_to_screen(&context->nkctx, local);
+	lua_pushnumber(L, screen.x);
+	lua_pushnumber(L, screen.y);
+	lua_pushnumber(L, screen.w);
+	lua_pushnumber(L, screen.h);
+	return 4;
+}
+
+static int nk_love_layout_space_rect_to_local(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 5);
+	nk_love_assert_context(L, 1);
+	struct nk_rect screen;
+	screen.x = luaL_checknumber(L, 2);
+	screen.y = luaL_checknumber(L, 3);
+	screen.w = luaL_checknumber(L, 4);
+	screen.h = luaL_checknumber(L, 5);
+	struct nk_rect local = nk_layout_space_rect_to_screen(&context->nkctx, screen);
+	lua_pushnumber(L, local.x);
+	lua_pushnumber(L, local.y);
+	lua_pushnumber(L, local.w);
+	lua_pushnumber(L, local.h);
+	return 4;
+}
+
+static int nk_love_layout_ratio_from_pixel(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_context(L, 1);
+	float pixel_width = luaL_checknumber(L, 2);
+	float ratio = nk_layout_ratio_from_pixel(&context->nkctx, pixel_width);
+	lua_pushnumber(L, ratio);
+	return 1;
 }
 
 /*
  * ===============================================================
  *
- *                          WINDOW
+ *                          WIDGETS
  *
  * ===============================================================
  */
 
-static int nk_love_window_begin(lua_State *L)
+static int nk_love_group_begin(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) >= 1);
+	nk_love_assert_argc(L, lua_gettop(L) >= 2);
 	nk_love_assert_context(L, 1);
-	const char *name, *title;
-	int bounds_begin;
-	if (lua_isnumber(L, 3)) {
-		nk_love_assert_argc(L, lua_gettop(L) >= 6);
-		name = title = luaL_checkstring(L, 2);
-		bounds_begin = 3;
-	} else {
-		nk_love_assert_argc(L, lua_gettop(L) >= 7);
-		name = luaL_checkstring(L, 2);
-		title = luaL_checkstring(L, 3);
-		bounds_begin = 4;
-	}
-	nk_flags flags = nk_love_parse_window_flags(L, bounds_begin + 4, lua_gettop(L));
-	float x = luaL_checknumber(L, bounds_begin);
-	float y = luaL_checknumber(L, bounds_begin + 1);
-	float width = luaL_checknumber(L, bounds_begin + 2);
-	float height = luaL_checknumber(L, bounds_begin + 3);
-	int open = nk_begin_titled(&context->nkctx, name, title, nk_rect(x, y, width, height), flags);
+	const char *title = luaL_checkstring(L, 2);
+	nk_flags flags = nk_love_parse_window_flags(L, 3, lua_gettop(L));
+	int open = nk_group_begin(&context->nkctx, title, flags);
 	lua_pushboolean(L, open);
 	return 1;
 }
 
-static int nk_love_window_end(lua_State *L)
+static int nk_love_group_end(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
 	nk_love_assert_context(L, 1);
-	nk_end(&context->nkctx);
+	nk_group_end(&context->nkctx);
 	return 0;
 }
 
-static int nk_love_window(lua_State *L)
+static int nk_love_group(lua_State *L)
 {
-	nk_love_assert(L, lua_checkstack(L, 2), "%s: failed to allocate stack space");
+	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
+	nk_love_assert_argc(L, lua_gettop(L) >= 3);
 	if (!lua_isfunction(L, -1))
 		luaL_typerror(L, lua_gettop(L), "function");
+	lua_pushvalue(L, 1);
 	lua_insert(L, 2);
 	lua_pushvalue(L, 1);
 	lua_insert(L, 3);
-	lua_getfield(L, 1, "windowBegin");
-	lua_insert(L, 3);
-	lua_call(L, lua_gettop(L) - 3, 1);
+	lua_insert(L, 2);
+	lua_getfield(L, 1, "groupBegin");
+	lua_insert(L, 4);
+	lua_call(L, lua_gettop(L) - 4, 1);
 	int open = lua_toboolean(L, -1);
 	lua_pop(L, 1);
 	if (open) {
-		lua_pushvalue(L, 1);
+		lua_call(L, 1, 0);
+		lua_getfield(L, 1, "groupEnd");
+		lua_insert(L, 1);
 		lua_call(L, 1, 0);
 	} else {
-		lua_pop(L, 1);
+		lua_pop(L, 3);
 	}
-	lua_getfield(L, -1, "windowEnd");
-	lua_insert(L, 1);
-	lua_call(L, 1, 0);
 	return 0;
 }
 
-static int nk_love_window_get_bounds(lua_State *L)
+static int nk_love_group_get_scroll(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
 	nk_love_assert_context(L, 1);
-	struct nk_rect rect = nk_window_get_bounds(&context->nkctx);
-	lua_pushnumber(L, rect.x);
-	lua_pushnumber(L, rect.y);
-	lua_pushnumber(L, rect.w);
-	lua_pushnumber(L, rect.h);
-	return 4;
+	const char *id = luaL_checkstring(L, 2);
+	nk_uint x_offset, y_offset;
+	nk_group_get_scroll(&context->nkctx, id, &x_offset, &y_offset);
+	lua_pushinteger(L, x_offset);
+	lua_pushinteger(L, y_offset);
+	return 2;
 }
 
-static int nk_love_window_get_position(lua_State *L)
+static int nk_love_group_set_scroll(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_argc(L, lua_gettop(L) == 4);
 	nk_love_assert_context(L, 1);
-	struct nk_vec2 pos = nk_window_get_position(&context->nkctx);
-	lua_pushnumber(L, pos.x);
-	lua_pushnumber(L, pos.y);
+	const char *id = luaL_checkstring(L, 2);
+	nk_uint x_offset = luaL_checkint(L, 3);
+	nk_uint y_offset = luaL_checkint(L, 4);
+	nk_group_set_scroll(&context->nkctx, id, x_offset, y_offset);
+	return 0;
+}
+
+static struct nk_list_view *nk_love_open_list_view(lua_State *L, int id_index)
+{
+	int top = lua_gettop(L);
+	const char *id = luaL_checkstring(L, id_index);
+	int row_height = luaL_checkint(L, top - 1);
+	int row_count = luaL_checkint(L, top);
+	nk_flags flags = nk_love_parse_window_flags(L, id_index + 1, top - 2);
+	nk_love_assert(L, context->list_view_count < NK_LOVE_MAX_LIST_VIEWS,
+		"%s: too many nested list views");
+	struct nk_list_view *view = &context->list_views[context->list_view_count];
+	if (!nk_list_view_begin(&context->nkctx, view, id, flags, row_height, row_count))
+		return NULL;
+	context->list_view_count++;
+	return view;
+}
+
+static int nk_love_list_view_begin(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 4);
+	nk_love_assert_context(L, 1);
+	struct nk_list_view *view = nk_love_open_list_view(L, 2);
+	if (view == NULL) {
+		lua_pushnil(L);
+		return 1;
+	}
+	lua_pushinteger(L, view->begin + 1);
+	lua_pushinteger(L, view->count);
 	return 2;
 }
 
-static int nk_love_window_get_size(lua_State *L)
+static int nk_love_list_view_end(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_context(L, 1);
+	nk_love_assert(L, context->list_view_count > 0, "%s: no list view to end");
+	nk_list_view_end(&context->list_views[--context->list_view_count]);
+	return 0;
+}
+
+static int nk_love_list_view(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 5);
+	nk_love_assert_context(L, 1);
+	if (!lua_isfunction(L, -1))
+		luaL_typerror(L, lua_gettop(L), "function");
+	lua_insert(L, 2);
+	struct nk_list_view *view = nk_love_open_list_view(L, 3);
+	if (view == NULL)
+		return 0;
+	int i, begin = view->begin, count = view->count;
+	for (i = begin; i < begin + count; ++i) {
+		lua_pushvalue(L, 2);
+		lua_pushvalue(L, 1);
+		lua_pushinteger(L, i + 1);
+		lua_call(L, 2, 0);
+	}
+	nk_love_assert(L, context->list_view_count > 0, "%s: list view ended inside its callback");
+	nk_list_view_end(&context->list_views[--context->list_view_count]);
+	return 0;
+}
+
+static int nk_love_tree_push(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 3 && argc <= 5);
 	nk_love_assert_context(L, 1);
-	struct nk_vec2 size = nk_window_get_size(&context->nkctx);
-	lua_pushnumber(L, size.x);
-	lua_pushnumber(L, size.y);
-	return 2;
+	enum nk_tree_type type = nk_love_checktree(L, 2);
+	const char *title = luaL_checkstring(L, 3);
+	struct nk_image image;
+	int use_image = 0;
+	if (argc >= 4 && !lua_isnil(L, 4)) {
+		nk_love_checkImage(L, 4, &image);
+		use_image = 1;
+	}
+	enum nk_collapse_states state = NK_MINIMIZED;
+	if (argc >= 5 && !lua_isnil(L, 5))
+		state = nk_love_checkstate(L, 5);
+	lua_Debug ar;
+	lua_getstack(L, 1, &ar);
+	lua_getinfo(L, "l", &ar);
+	int id = ar.currentline;
+	int open = 0;
+	if (use_image)
+		open = nk_tree_image_push_hashed(&context->nkctx, type, image, title, state, title, strlen(title), id);
+	else
+		open = nk_tree_push_hashed(&context->nkctx, type, title, state, title, strlen(title), id);
+	lua_pushboolean(L, open);
+	return 1;
 }
 
-static int nk_love_window_get_scroll(lua_State *L)
+static int nk_love_tree_pop(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
 	nk_love_assert_context(L, 1);
-	nk_uint offset_x, offset_y;
-	nk_window_get_scroll(&context->nkctx, &offset_x, &offset_y);
-	lua_pushinteger(L, offset_x);
-	lua_pushinteger(L, offset_y);
-	return 2;
+	nk_tree_pop(&context->nkctx);
+	return 0;
 }
 
-static int nk_love_window_get_content_region(lua_State *L)
+static int nk_love_tree(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	struct nk_rect rect = nk_window_get_content_region(&context->nkctx);
-	lua_pushnumber(L, rect.x);
-	lua_pushnumber(L, rect.y);
-	lua_pushnumber(L, rect.w);
-	lua_pushnumber(L, rect.h);
-	return 4;
+	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
+	nk_love_assert_argc(L, lua_gettop(L) >= 4);
+	if (!lua_isfunction(L, -1))
+		luaL_typerror(L, lua_gettop(L), "function");
+	lua_pushvalue(L, 1);
+	lua_insert(L, 2);
+	lua_pushvalue(L, 1);
+	lua_insert(L, 3);
+	lua_insert(L, 2);
+	lua_getfield(L, 1, "treePush");
+	lua_insert(L, 4);
+	lua_call(L, lua_gettop(L) - 4, 1);
+	int open = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+	if (open) {
+		lua_call(L, 1, 0);
+		lua_getfield(L, 1, "treePop");
+		lua_insert(L, 1);
+		lua_call(L, 1, 0);
+	}
+	return 0;
 }
 
-static int nk_love_window_has_focus(lua_State *L)
+static int nk_love_tree_state_push(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 3 && argc <= 5);
 	nk_love_assert_context(L, 1);
-	int has_focus = nk_window_has_focus(&context->nkctx);
-	lua_pushboolean(L, has_focus);
+	enum nk_tree_type type = nk_love_checktree(L, 2);
+	const char *title = luaL_checkstring(L, 3);
+	struct nk_image image;
+	int use_image = 0;
+	if (argc >= 4 && !lua_isnil(L, 4)) {
+		nk_love_checkImage(L, 4, &image);
+		use_image = 1;
+	}
+	enum nk_collapse_states state = NK_MINIMIZED;
+	if (argc >= 5)
+		state = nk_love_checkstate(L, 5);
+
+	int open = 0;
+	if (use_image)
+		open = nk_tree_state_image_push(&context->nkctx, type, image, title, &state);
+	else
+		open = nk_tree_state_push(&context->nkctx, type, title, &state);
+	lua_pushboolean(L, open);
 	return 1;
 }
 
-static int nk_love_window_is_collapsed(lua_State *L)
+static int nk_love_tree_state_pop(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	int is_collapsed = nk_window_is_collapsed(&context->nkctx, name);
-	lua_pushboolean(L, is_collapsed);
-	return 1;
+	nk_tree_state_pop(&context->nkctx);
+	return 0;
 }
 
-static int nk_love_window_is_closed(lua_State *L)
+static int nk_love_tree_state(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	int is_closed = nk_window_is_closed(&context->nkctx, name);
-	lua_pushboolean(L, is_closed);
-	return 1;
+	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
+	nk_love_assert_argc(L, lua_gettop(L) >= 4);
+	if (!lua_isfunction(L, -1))
+		luaL_typerror(L, lua_gettop(L), "function");
+	lua_pushvalue(L, 1);
+	lua_insert(L, 2);
+	lua_pushvalue(L, 1);
+	lua_insert(L, 3);
+	lua_insert(L, 2);
+	lua_getfield(L, 1, "treeStatePush");
+	lua_insert(L, 4);
+	lua_call(L, lua_gettop(L) - 4, 1);
+	int open = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+	if (open) {
+		lua_call(L, 1, 0);
+		lua_getfield(L, 1, "treeStatePop");
+		lua_insert(L, 1);
+		lua_call(L, 1, 0);
+	}
+	return 0;
 }
 
-static int nk_love_window_is_hidden(lua_State *L)
+static int nk_love_flags(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	int is_hidden = nk_window_is_hidden(&context->nkctx, name);
-	lua_pushboolean(L, is_hidden);
+	nk_flags flags = nk_love_parse_window_flags(L, 1, lua_gettop(L));
+	lua_pushnumber(L, flags);
 	return 1;
 }
 
-static int nk_love_window_is_active(lua_State *L)
+static int nk_love_color_rgba(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	int is_active = nk_window_is_active(&context->nkctx, name);
-	lua_pushboolean(L, is_active);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 3 && argc <= 5);
+	int r = luaL_checkint(L, 1);
+	int g = luaL_checkint(L, 2);
+	int b = luaL_checkint(L, 3);
+	int a = 255;
+	if (argc >= 4)
+		a = luaL_checkint(L, 4);
+	int packed = argc == 5 && nk_love_checkboolean(L, 5);
+	nk_love_pushcolor(L, nk_rgba(r, g, b, a), packed);
 	return 1;
 }
 
-static int nk_love_window_is_hovered(lua_State *L)
+static int nk_love_color_hsva(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	int is_hovered = nk_window_is_hovered(&context->nkctx);
-	lua_pushboolean(L, is_hovered);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 3 && argc <= 5);
+	int h = NK_CLAMP(0, luaL_checkint(L, 1), 255);
+	int s = NK_CLAMP(0, luaL_checkint(L, 2), 255);
+	int v = NK_CLAMP(0, luaL_checkint(L, 3), 255);
+	int a = 255;
+	if (argc >= 4)
+		a = NK_CLAMP(0, luaL_checkint(L, 4), 255);
+	int packed = argc == 5 && nk_love_checkboolean(L, 5);
+	nk_love_pushcolor(L, nk_hsva(h, s, v, a), packed);
 	return 1;
 }
 
-static int nk_love_window_is_any_hovered(lua_State *L)
+static int nk_love_color_parse_rgba(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	int is_any_hovered = nk_window_is_any_hovered(&context->nkctx);
-	lua_pushboolean(L, is_any_hovered);
-	return 1;
+	struct nk_color rgba = nk_love_checkcolor(L, 1);
+	lua_pushnumber(L, rgba.r);
+	lua_pushnumber(L, rgba.g);
+	lua_pushnumber(L, rgba.b);
+	lua_pushnumber(L, rgba.a);
+	return 4;
 }
 
-static int nk_love_item_is_any_active(lua_State *L)
+static int nk_love_color_parse_hsva(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	lua_pushboolean(L, nk_love_is_active(&context->nkctx));
-	return 1;
+	struct nk_color rgba = nk_love_checkcolor(L, 1);
+	int h, s, v, a2;
+	nk_color_hsva_i(&h, &s, &v, &a2, rgba);
+	lua_pushnumber(L, h);
+	lua_pushnumber(L, s);
+	lua_pushnumber(L, v);
+	lua_pushnumber(L, a2);
+	return 4;
 }
 
-static int nk_love_window_set_bounds(lua_State *L)
+static int nk_love_label(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 6);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 2 && argc <= 4);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	struct nk_rect bounds;
-	bounds.x = luaL_checknumber(L, 3);
-	bounds.y = luaL_checknumber(L, 4);
-	bounds.w = luaL_checknumber(L, 5);
-	bounds.h = luaL_checknumber(L, 6);
-	nk_window_set_bounds(&context->nkctx, name, bounds);
+	const char *text = luaL_checkstring(L, 2);
+	nk_flags align = NK_TEXT_LEFT;
+	int wrap = 0;
+	struct nk_color color;
+	int use_color = 0;
+	if (argc >= 3) {
+		const char *align_string = luaL_checkstring(L, 3);
+		if (!strcmp(align_string, "wrap"))
+			wrap = 1;
+		else
+			align = nk_love_checkalign(L, 3);
+		if (argc >= 4) {
+			color = nk_love_checkcolor(L, 4);
+			use_color = 1;
+		}
+	}
+	if (use_color) {
+		if (wrap)
+			nk_label_colored_wrap(&context->nkctx, text, color);
+		else
+			nk_label_colored(&context->nkctx, text, align, color);
+	} else {
+		if (wrap)
+			nk_label_wrap(&context->nkctx, text);
+		else
+			nk_label(&context->nkctx, text, align);
+	}
 	return 0;
 }
 
-static int nk_love_window_set_position(lua_State *L)
+static int nk_love_image(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 4);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc == 2 || argc == 6);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	struct nk_vec2 pos;
-	pos.x = luaL_checknumber(L, 3);
-	pos.y = luaL_checknumber(L, 4);
-	nk_window_set_position(&context->nkctx, name, pos);
+	struct nk_image image;
+	nk_love_checkImage(L, 2, &image);
+	if (argc == 2) {
+		nk_image(&context->nkctx, image);
+	} else {
+		float x = luaL_checknumber(L, 3);
+		float y = luaL_checknumber(L, 4);
+		float w = luaL_checknumber(L, 5);
+		float h = luaL_checknumber(L, 6);
+		float line_thickness;
+		struct nk_color color;
+		nk_love_getPen(&line_thickness, &color);
+		nk_draw_image(&context->nkctx.current->buffer, nk_rect(x, y, w, h), &image, color);
+	}
 	return 0;
 }
 
-static int nk_love_window_set_size(lua_State *L)
+static int nk_love_button(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 4);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 2 && argc <= 3);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	struct nk_vec2 size;
-	size.x = luaL_checknumber(L, 3);
-	size.y = luaL_checknumber(L, 4);
-	nk_window_set_size(&context->nkctx, name, size);
-	return 0;
+	const char *title = NULL;
+	if (!lua_isnil(L, 2))
+		title = luaL_checkstring(L, 2);
+	int use_color = 0, use_image = 0;
+	struct nk_color color;
+	enum nk_symbol_type symbol = NK_SYMBOL_NONE;
+	struct nk_image image;
+	if (argc >= 3 && !lua_isnil(L, 3)) {
+		if (nk_love_tocolor(L, 3, &color)) {
+			use_color = 1;
+		} else if (lua_isstring(L, 3)) {
+			symbol = nk_love_checksymbol(L, 3);
+		} else {
+			nk_love_checkImage(L, 3, &image);
+			use_image = 1;
+		}
+	}
+	nk_flags align = context->nkctx.style.button.text_alignment;
+	int activated = 0;
+	if (title != NULL) {
+		if (use_color)
+			nk_love_assert(L, 0, "%s: color buttons can't have titles");
+		else if (symbol != NK_SYMBOL_NONE)
+			activated = nk_button_symbol_label(&context->nkctx, symbol, title, align);
+		else if (use_image)
+			activated = nk_button_image_label(&context->nkctx, image, title, align);
+		else
+			activated = nk_button_label(&context->nkctx, title);
+	} else {
+		if (use_color)
+			activated = nk_button_color(&context->nkctx, color);
+		else if (symbol != NK_SYMBOL_NONE)
+			activated = nk_button_symbol(&context->nkctx, symbol);
+		else if (use_image)
+			activated = nk_button_image(&context->nkctx, image);
+		else
+			nk_love_assert(L, 0, "%s: must specify a title, color, symbol, and/or image");
+	}
+	lua_pushboolean(L, activated);
+	return 1;
 }
 
-static int nk_love_window_set_focus(lua_State *L)
+static int nk_love_button_set_behavior(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 2);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	nk_window_set_focus(&context->nkctx, name);
-	return 0;
-}
-
-static int nk_love_window_set_scroll(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 3);
-	nk_love_assert_context(L, 1);
-	nk_uint offset_x, offset_y;
-	offset_x = luaL_checkinteger(L, 2);
-	offset_y = luaL_checkinteger(L, 3);
-	nk_window_set_scroll(&context->nkctx, offset_x, offset_y);
+	enum nk_button_behavior behavior = nk_love_checkbehavior(L, 2);
+	nk_button_set_behavior(&context->nkctx, behavior);
 	return 0;
 }
 
-static int nk_love_window_close(lua_State *L)
+static int nk_love_button_push_behavior(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 2);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	nk_window_close(&context->nkctx, name);
+	enum nk_button_behavior behavior = nk_love_checkbehavior(L, 2);
+	nk_button_push_behavior(&context->nkctx, behavior);
 	return 0;
 }
 
-static int nk_love_window_collapse(lua_State *L)
+static int nk_love_button_pop_behavior(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	nk_window_collapse(&context->nkctx, name, NK_MINIMIZED);
+	nk_button_pop_behavior(&context->nkctx);
 	return 0;
 }
 
-static int nk_love_window_expand(lua_State *L)
+static int nk_love_checkbox(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	nk_window_collapse(&context->nkctx, name, NK_MAXIMIZED);
-	return 0;
+	const char *text = luaL_checkstring(L, 2);
+	if (lua_isboolean(L, 3)) {
+		int value = lua_toboolean(L, 3);
+		value = nk_check_label(&context->nkctx, text, value);
+		lua_pushboolean(L, value);
+	} else if (lua_istable(L, 3)) {
+		lua_getfield(L, 3, "value");
+		if (!lua_isboolean(L, -1))
+			luaL_argerror(L, 3, "should have a boolean value");
+		int value = lua_toboolean(L, -1);
+		int changed = nk_checkbox_label(&context->nkctx, text, &value);
+		if (changed) {
+			lua_pushboolean(L, value);
+			lua_setfield(L, 3, "value");
+		}
+		lua_pushboolean(L, changed);
+	} else {
+		luaL_typerror(L, 3, "boolean or table");
+	}
+	return 1;
 }
 
-static int nk_love_window_show(lua_State *L)
+static int nk_love_radio(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc == 3 || argc == 4);
 	nk_love_assert_context(L, 1);
 	const char *name = luaL_checkstring(L, 2);
-	nk_window_show(&context->nkctx, name, NK_SHOWN);
-	return 0;
+	const char *text = name;
+	if (argc == 4)
+		text = luaL_checkstring(L, 3);
+	if (lua_isstring(L, -1)) {
+		const char *value = lua_tostring(L, -1);
+		int active = !strcmp(value, name);
+		active = nk_option_label(&context->nkctx, text, active);
+		if (active)
+			lua_pushstring(L, name);
+		else
+			lua_pushstring(L, value);
+	} else if (lua_istable(L, -1)) {
+		lua_getfield(L, -1, "value");
+		if (!lua_isstring(L, -1))
+			luaL_argerror(L, argc, "should have a string value");
+		const char *value = lua_tostring(L, -1);
+		int active = !strcmp(value, name);
+		int changed = nk_radio_label(&context->nkctx, text, &active);
+		if (changed && active) {
+			lua_pushstring(L, name);
+			lua_setfield(L, -3, "value");
+		}
+		lua_pushboolean(L, changed);
+	} else {
+		luaL_typerror(L, argc, "string or table");
+	}
+	return 1;
 }
 
-static int nk_love_window_hide(lua_State *L)
+static int nk_love_selectable(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 3 && argc <= 5);
 	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	nk_window_show(&context->nkctx, name, NK_HIDDEN);
-	return 0;
+	const char *text = luaL_checkstring(L, 2);
+	struct nk_image image;
+	int use_image = 0;
+	if (argc >= 4 && !lua_isnil(L, 3)) {
+		nk_love_checkImage(L, 3, &image);
+		use_image = 1;
+	}
+	nk_flags align = NK_TEXT_LEFT;
+	if (argc >= 5)
+		align = nk_love_checkalign(L, 4);
+	if (lua_isboolean(L, -1)) {
+		int value = lua_toboolean(L, -1);
+		if (use_image)
+			value = nk_select_image_label(&context->nkctx, image, text, align, value);
+		else
+			value = nk_select_label(&context->nkctx, text, align, value);
+		lua_pushboolean(L, value);
+	} else if (lua_istable(L, -1)) {
+		lua_getfield(L, -1, "value");
+		if (!lua_isboolean(L, -1))
+			luaL_argerror(L, argc, "should have a boolean value");
+		int value = lua_toboolean(L, -1);
+		int changed;
+		if (use_image)
+			changed = nk_selectable_image_label(&context->nkctx, image, text, align, &value);
+		else
+			changed = nk_selectable_label(&context->nkctx, text, align, &value);
+		if (changed) {
+			lua_pushboolean(L, value);
+			lua_setfield(L, -3, "value");
+		}
+		lua_pushboolean(L, changed);
+	} else {
+		luaL_typerror(L, argc, "boolean or table");
+	}
+	return 1;
 }
 
-/*
- * ===============================================================
- *
- *                           LAYOUT
- *
- * ===============================================================
- */
-
-static int nk_love_layout_row(lua_State *L)
+static int nk_love_slider(lua_State *L)
 {
-	int argc = lua_gettop(L);
-	if (argc == 5 && lua_isfunction(L, 5)) {
-		nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
-		lua_pushvalue(L, 1);
-		lua_insert(L, 2);
-		lua_pushvalue(L, 1);
-		lua_insert(L, 3);
-		lua_insert(L, 2);
-		lua_getfield(L, 1, "layoutRowBegin");
-		lua_insert(L, 4);
-		lua_call(L, 4, 0);
-		lua_call(L, 1, 0);
-		lua_getfield(L, 1, "layoutRowEnd");
-		lua_insert(L, 1);
-		lua_call(L, 1, 0);
-	} else {
-		nk_love_assert_argc(L, argc >= 4 && argc <= 5);
-		nk_love_assert_context(L, 1);
-		enum nk_layout_format format = nk_love_checkformat(L, 2);
-		float height = luaL_checknumber(L, 3);
-		int use_ratios = 0;
-		if (format == NK_DYNAMIC) {
-			nk_love_assert_argc(L, argc == 4);
-			if (lua_isnumber(L, 4)) {
-				int cols = luaL_checkint(L, 4);
-				nk_layout_row_dynamic(&context->nkctx, height, cols);
-			} else {
-				if (!lua_istable(L, 4))
-					luaL_argerror(L, 4, "should be a number or table");
-				use_ratios = 1;
-			}
-		} else if (format == NK_STATIC) {
-			if (argc == 5) {
-				int item_width = luaL_checkint(L, 4);
-				int cols = luaL_checkint(L, 5);
-				nk_layout_row_static(&context->nkctx, height, item_width, cols);
-			} else {
-				if (!lua_istable(L, 4))
-					luaL_argerror(L, 4, "should be a number or table");
-				use_ratios = 1;
-			}
-		}
-		if (use_ratios) {
-			int cols = lua_objlen(L, -1);
-			int i, j;
-			for (i = 1, j = context->layout_ratio_count; i <= cols && j < NK_LOVE_MAX_RATIOS; ++i, ++j) {
-				lua_rawgeti(L, -1, i);
-				if (!lua_isnumber(L, -1))
-					luaL_argerror(L, lua_gettop(L) - 1, "should contain numbers only");
-				context->layout_ratios[j] = lua_tonumber(L, -1);
-				lua_pop(L, 1);
-			}
-			nk_layout_row(&context->nkctx, format, height, cols, context->layout_ratios + context->layout_ratio_count);
-			context->layout_ratio_count += cols;
+	nk_love_assert_argc(L, lua_gettop(L) == 5);
+	nk_love_assert_context(L, 1);
+	float min = luaL_checknumber(L, 2);
+	float max = luaL_checknumber(L, 4);
+	float step = luaL_checknumber(L, 5);
+	if (lua_isnumber(L, 3)) {
+		float value = lua_tonumber(L, 3);
+		value = nk_slide_float(&context->nkctx, min, value, max, step);
+		lua_pushnumber(L, value);
+	} else if (lua_istable(L, 3)) {
+		lua_getfield(L, 3, "value");
+		if (!lua_isnumber(L, -1))
+			luaL_argerror(L, 3, "should have a number value");
+		float value = lua_tonumber(L, -1);
+		int changed = nk_slider_float(&context->nkctx, min, &value, max, step);
+		if (changed) {
+			lua_pushnumber(L, value);
+			lua_setfield(L, 3, "value");
 		}
+		lua_pushboolean(L, changed);
+	} else {
+		luaL_typerror(L, 3, "number or table");
 	}
-	return 0;
+	return 1;
 }
 
-static int nk_love_layout_row_begin(lua_State *L)
+static int nk_love_progress(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 4);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 3 || argc <= 4);
 	nk_love_assert_context(L, 1);
-	enum nk_layout_format format = nk_love_checkformat(L, 2);
-	float height = luaL_checknumber(L, 3);
-	int cols = luaL_checkint(L, 4);
-	nk_layout_row_begin(&context->nkctx, format, height, cols);
-	return 0;
+	nk_size max = luaL_checklong(L, 3);
+	int modifiable = 0;
+	if (argc >= 4 && !lua_isnil(L, 4))
+		modifiable = nk_love_checkboolean(L, 4);
+	if (lua_isnumber(L, 2)) {
+		nk_size value = lua_tonumber(L, 2);
+		value = nk_prog(&context->nkctx, value, max, modifiable);
+		lua_pushnumber(L, value);
+	} else if (lua_istable(L, 2)) {
+		lua_getfield(L, 2, "value");
+		if (!lua_isnumber(L, -1))
+			luaL_argerror(L, 2, "should have a number value");
+		nk_size value = (nk_size) lua_tonumber(L, -1);
+		int changed = nk_progress(&context->nkctx, &value, max, modifiable);
+		if (changed) {
+			lua_pushnumber(L, value);
+			lua_setfield(L, 2, "value");
+		}
+		lua_pushboolean(L, changed);
+	} else {
+		luaL_typerror(L, 2, "number or table");
+	}
+	return 1;
 }
 
-static int nk_love_layout_row_push(lua_State *L)
-{
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_context(L, 1);
-	float value = luaL_checknumber(L, 2);
-	nk_layout_row_push(&context->nkctx, value);
-	return 0;
+struct nk_love_samples {
+	const float *data;
+	int table;
+	int count;
+	const struct nk_love_series *series;
+};
+
+/*
+ * Samples are a Series, a Lua array, a string of packed 32-bit floats, a LOVE
+ * Data object holding 32-bit floats, or a light userdata pointer followed by
+ * a sample count. Returns the index of the argument after the samples.
+ */
+static int nk_love_checksamples(lua_State *L, int index, struct nk_love_samples *samples)
+{
+	samples->data = NULL;
+	samples->table = 0;
+	samples->series = nk_love_toudata(L, index, "series");
+	if (samples->series != NULL) {
+		samples->data = samples->series->samples;
+		samples->count = samples->series->count;
+		return index + 1;
+	} else if (lua_istable(L, index)) {
+		samples->table = index;
+		samples->count = lua_objlen(L, index);
+		return index + 1;
+	} else if (lua_type(L, index) == LUA_TSTRING) {
+		size_t len;
+		samples->data = (const float *) lua_tolstring(L, index, &len);
+		samples->count = len / sizeof(float);
+		return index + 1;
+	} else if (lua_islightuserdata(L, index)) {
+		samples->data = lua_touserdata(L, index);
+		samples->count = luaL_checkint(L, index + 1);
+		luaL_argcheck(L, samples->count >= 0, index + 1, "sample count must not be negative");
+		return index + 2;
+	} else if (lua_isuserdata(L, index)) {
+		lua_getfield(L, index, "getPointer");
+		lua_getfield(L, index, "getSize");
+		if (!lua_isfunction(L, -1) || !lua_isfunction(L, -2))
+			luaL_typerror(L, index, "Data");
+		lua_pushvalue(L, index);
+		lua_call(L, 1, 1);
+		samples->count = lua_tointeger(L, -1) / sizeof(float);
+		lua_pop(L, 1);
+		lua_pushvalue(L, index);
+		lua_call(L, 1, 1);
+		samples->data = lua_touserdata(L, -1);
+		lua_pop(L, 1);
+		return index + 1;
+	}
+	luaL_typerror(L, index, "table, string, Data or light userdata");
+	return index;
 }
 
-static int nk_love_layout_row_end(lua_State *L)
+static float nk_love_sample(lua_State *L, const struct nk_love_samples *samples, int i)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	nk_layout_row_end(&context->nkctx);
-	return 0;
+	if (samples->data != NULL)
+		return samples->data[i];
+	lua_rawgeti(L, samples->table, i + 1);
+	float value = lua_tonumber(L, -1);
+	lua_pop(L, 1);
+	return value;
 }
 
-static int nk_love_layout_template_begin(lua_State *L)
+static void nk_love_sample_range(lua_State *L, const struct nk_love_samples *samples,
+	int a, int b, float *lo, float *hi)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_context(L, 1);
-	float height = luaL_checknumber(L, 2);
-	nk_layout_row_template_begin(&context->nkctx, height);
-	return 0;
+	const struct nk_love_series *series = samples->series;
+	*lo = *hi = nk_love_sample(L, samples, a);
+	if (series == NULL) {
+		for (++a; a < b; ++a) {
+			float value = nk_love_sample(L, samples, a);
+			*lo = NK_MIN(*lo, value);
+			*hi = NK_MAX(*hi, value);
+		}
+		return;
+	}
+	int level;
+	for (level = 0; a < b; ++level) {
+		const float *node;
+		if (a & 1) {
+			node = level > 0 ? &series->pyramid[2 * (series->levels[level - 1] + a)] : NULL;
+			*lo = NK_MIN(*lo, node ? node[0] : series->samples[a]);
+			*hi = NK_MAX(*hi, node ? node[1] : series->samples[a]);
+			a++;
+		}
+		if (b & 1) {
+			b--;
+			node = level > 0 ? &series->pyramid[2 * (series->levels[level - 1] + b)] : NULL;
+			*lo = NK_MIN(*lo, node ? node[0] : series->samples[b]);
+			*hi = NK_MAX(*hi, node ? node[1] : series->samples[b]);
+		}
+		a >>= 1;
+		b >>= 1;
+	}
 }
 
-static int nk_love_layout_template_push(lua_State *L)
+static int nk_love_chart(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2 || lua_gettop(L) == 3);
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 5 && argc <= 8);
 	nk_love_assert_context(L, 1);
-	const char *mode = luaL_checkstring(L, 2);
-	if (!strcmp(mode, "dynamic")) {
-		nk_love_assert_argc(L, lua_gettop(L) == 2);
-		nk_layout_row_template_push_dynamic(&context->nkctx);
-	} else {
-		nk_love_assert_argc(L, lua_gettop(L) == 3);
-		float width = luaL_checknumber(L, 3);
-		if (!strcmp(mode, "variable")) {
-			nk_layout_row_template_push_variable(&context->nkctx, width);
-		} else if (!strcmp(mode, "static")) {
-			nk_layout_row_template_push_static(&context->nkctx, width);
-		} else {
-			return luaL_argerror(L, 2, "expecting 'dynamic', 'variable', or 'static' modes");
+	enum nk_chart_type type = nk_love_checkcharttype(L, 2);
+	struct nk_love_samples samples;
+	int next = nk_love_checksamples(L, 3, &samples);
+	nk_love_assert_argc(L, argc >= next + 1 && argc <= next + (samples.series ? 3 : 1));
+	float min = luaL_checknumber(L, next);
+	float max = luaL_checknumber(L, next + 1);
+	int first = 0, count = samples.count;
+	if (argc >= next + 2 && !lua_isnil(L, next + 2))
+		first = NK_CLAMP(0, luaL_checkint(L, next + 2) - 1, samples.count);
+	count -= first;
+	if (argc >= next + 3 && !lua_isnil(L, next + 3))
+		count = NK_CLAMP(0, luaL_checkint(L, next + 3), count);
+	struct nk_context *ctx = &context->nkctx;
+	int columns = (int) NK_MAX(1, nk_widget_bounds(ctx).w);
+	int buckets = NK_MIN(count, columns);
+	int decimate = count > columns;
+	int pushes = decimate && type == NK_CHART_LINES ? 2 : 1;
+	int i, j, hovered = -1, clicked = -1;
+	if (nk_chart_begin(ctx, type, buckets * pushes, min, max)) {
+		for (i = 0; i < buckets; ++i) {
+			int a = first + (int)((long long) i * count / buckets);
+			int b = first + (int)((long long) (i + 1) * count / buckets);
+			float values[2];
+			if (decimate) {
+				nk_love_sample_range(L, &samples, a, b, &values[0], &values[1]);
+				if (pushes == 1)
+					values[0] = values[1];
+			} else {
+				values[0] = nk_love_sample(L, &samples, a);
+			}
+			for (j = 0; j < pushes; ++j) {
+				nk_flags event = nk_chart_push(ctx, values[j]);
+				if (event & NK_CHART_HOVERING)
+					hovered = a;
+				if (event & NK_CHART_CLICKED)
+					clicked = a;
+			}
 		}
+		nk_chart_end(ctx);
 	}
-	return 0;
+	if (clicked >= 0)
+		lua_pushinteger(L, clicked + 1);
+	else
+		lua_pushnil(L);
+	if (hovered >= 0)
+		lua_pushinteger(L, hovered + 1);
+	else
+		lua_pushnil(L);
+	return 2;
 }
 
-static int nk_love_layout_template_end(lua_State *L)
+static struct nk_love_series *nk_love_checkseries(lua_State *L, int index)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	nk_layout_row_template_end(&context->nkctx);
-	return 0;
+	struct nk_love_series *series = nk_love_toudata(L, index, "series");
+	if (series == NULL)
+		luaL_typerror(L, index, "Series");
+	return series;
 }
 
-static int nk_love_layout_template(lua_State *L)
+static void nk_love_series_set(lua_State *L, struct nk_love_series *series,
+	const struct nk_love_samples *samples)
 {
-	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
-	nk_love_assert_argc(L, lua_gettop(L) == 3);
-	if (!lua_isfunction(L, -1))
-		luaL_typerror(L, lua_gettop(L), "function");
-	lua_pushvalue(L, 1);
-	lua_insert(L, 2);
-	lua_pushvalue(L, 1);
-	lua_insert(L, 3);
-	lua_insert(L, 2);
-	lua_getfield(L, 1, "layoutTemplateBegin");
-	lua_insert(L, 4);
-	lua_call(L, 2, 0);
-	lua_call(L, 1, 0);
-	lua_getfield(L, 1, "layoutTemplateEnd");
-	lua_insert(L, 1);
-	lua_call(L, 1, 0);
-	return 0;
+	size_t levels[NK_LOVE_MAX_SERIES_LEVELS];
+	size_t size, nodes = 0;
+	int i, level, level_count = 0;
+	for (size = samples->count; size > 1; size = (size + 1) / 2) {
+		levels[level_count++] = nodes;
+		nodes += (size + 1) / 2;
+	}
+	float *data = malloc(sizeof(float) * (samples->count > 0 ? samples->count : 1));
+	float *pyramid = malloc(sizeof(float) * 2 * (nodes > 0 ? nodes : 1));
+	if (data == NULL || pyramid == NULL) {
+		free(data);
+		free(pyramid);
+		nk_love_assert_alloc(L, NULL);
+	}
+	for (i = 0; i < samples->count; ++i)
+		data[i] = nk_love_sample(L, samples, i);
+	size = samples->count;
+	for (level = 0; level < level_count; ++level) {
+		float *node = &pyramid[2 * levels[level]];
+		const float *child = level > 0 ? &pyramid[2 * levels[level - 1]] : NULL;
+		for (i = 0; i < (int) size; i += 2) {
+			int last = i + 1 < (int) size ? i + 1 : i;
+			node[i] = child ? NK_MIN(child[2 * i], child[2 * last]) : NK_MIN(data[i], data[last]);
+			node[i + 1] = child ? NK_MAX(child[2 * i + 1], child[2 * last + 1]) : NK_MAX(data[i], data[last]);
+		}
+		size = (size + 1) / 2;
+	}
+	free(series->samples);
+	free(series->pyramid);
+	series->samples = data;
+	series->pyramid = pyramid;
+	memcpy(series->levels, levels, sizeof(levels));
+	series->level_count = level_count;
+	series->count = samples->count;
+	series->version++;
 }
 
-static int nk_love_layout_space_begin(lua_State *L)
+static int nk_love_new_series(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 4);
-	nk_love_assert_context(L, 1);
-	enum nk_layout_format format = nk_love_checkformat(L, 2);
-	float height = luaL_checknumber(L, 3);
-	int widget_count = luaL_checkint(L, 4);
-	nk_layout_space_begin(&context->nkctx, format, height, widget_count);
-	return 0;
+	nk_love_assert_argc(L, lua_gettop(L) >= 2 && lua_gettop(L) <= 3);
+	nk_love_checkcontext(L, 1);
+	struct nk_love_samples samples;
+	int next = nk_love_checksamples(L, 2, &samples);
+	nk_love_assert_argc(L, lua_gettop(L) == next - 1);
+	struct nk_love_series *series = lua_newuserdata(L, sizeof(struct nk_love_series));
+	nk_love_assert_alloc(L, series);
+	memset(series, 0, sizeof(struct nk_love_series));
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_getfield(L, -1, "series");
+	lua_setmetatable(L, -3);
+	lua_pop(L, 1);
+	nk_love_series_set(L, series, &samples);
+	series->version = 0;
+	return 1;
 }
 
-static int nk_love_layout_space_push(lua_State *L)
+static int nk_love_series_set_samples(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 5);
-	nk_love_assert_context(L, 1);
-	float x = luaL_checknumber(L, 2);
-	float y = luaL_checknumber(L, 3);
-	float width = luaL_checknumber(L, 4);
-	float height = luaL_checknumber(L, 5);
-	nk_layout_space_push(&context->nkctx, nk_rect(x, y, width, height));
+	nk_love_assert_argc(L, lua_gettop(L) >= 2 && lua_gettop(L) <= 3);
+	struct nk_love_series *series = nk_love_checkseries(L, 1);
+	struct nk_love_samples samples;
+	int next = nk_love_checksamples(L, 2, &samples);
+	nk_love_assert_argc(L, lua_gettop(L) == next - 1);
+	nk_love_series_set(L, series, &samples);
 	return 0;
 }
 
-static int nk_love_layout_space_end(lua_State *L)
+static int nk_love_series_get_count(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	nk_layout_space_end(&context->nkctx);
-	return 0;
+	struct nk_love_series *series = nk_love_checkseries(L, 1);
+	lua_pushinteger(L, series->count);
+	return 1;
 }
 
-static int nk_love_layout_space(lua_State *L)
+static int nk_love_series_get_range(lua_State *L)
 {
-	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
-	nk_love_assert_argc(L, lua_gettop(L) == 5);
-	if (!lua_isfunction(L, -1))
-		luaL_typerror(L, lua_gettop(L), "function");
-	lua_pushvalue(L, 1);
-	lua_insert(L, 2);
-	lua_pushvalue(L, 1);
-	lua_insert(L, 3);
-	lua_insert(L, 2);
-	lua_getfield(L, 1, "layoutSpaceBegin");
-	lua_insert(L, 4);
-	lua_call(L, 4, 0);
-	lua_call(L, 1, 0);
-	lua_getfield(L, 1, "layoutSpaceEnd");
-	lua_insert(L, 1);
-	lua_call(L, 1, 0);
-	return 0;
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	struct nk_love_series *series = nk_love_checkseries(L, 1);
+	int first = luaL_checkint(L, 2);
+	int count = luaL_checkint(L, 3);
+	luaL_argcheck(L, first >= 1 && first <= series->count, 2, "sample out of range");
+	luaL_argcheck(L, count >= 1 && first - 1 + count <= series->count, 3, "range out of bounds");
+	struct nk_love_samples samples = {series->samples, 0, series->count, series};
+	float lo, hi;
+	nk_love_sample_range(L, &samples, first - 1, first - 1 + count, &lo, &hi);
+	lua_pushnumber(L, lo);
+	lua_pushnumber(L, hi);
+	return 2;
 }
 
-static int nk_love_layout_space_bounds(lua_State *L)
+static int nk_love_series_get_version(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	struct nk_rect bounds = nk_layout_space_bounds(&context->nkctx);
-	lua_pushnumber(L, bounds.x);
-	lua_pushnumber(L, bounds.y);
-	lua_pushnumber(L, bounds.w);
-	lua_pushnumber(L, bounds.h);
-	return 4;
+	struct nk_love_series *series = nk_love_checkseries(L, 1);
+	lua_pushnumber(L, series->version);
+	return 1;
 }
 
-static int nk_love_layout_space_to_screen(lua_State *L)
+static int nk_love_series_gc(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	struct nk_love_series *series = lua_touserdata(L, 1);
+	free(series->samples);
+	free(series->pyramid);
+	return 0;
+}
+
+static int nk_love_color_picker(lua_State *L)
+{
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 2 && argc <= 3);
 	nk_love_assert_context(L, 1);
-	struct nk_vec2 local;
-	local.x = luaL_checknumber(L, 2);
-	local.y = luaL_checknumber(L, 3);
-	struct nk_vec2 screen = nk_layout_space_to_screen(&context->nkctx, local);
-	lua_pushnumber(L, screen.x);
-	lua_pushnumber(L, screen.y);
-	return 2;
+	enum nk_color_format format = NK_RGB;
+	if (argc >= 3)
+		format = nk_love_checkcolorformat(L, 3);
+	if (lua_isstring(L, 2)) {
+		struct nk_colorf color = nk_love_checkcolorf(L, 2);
+		color = nk_color_picker(&context->nkctx, color, format);
+		nk_love_pushcolor(L, nk_rgba((int) (color.r * 255), (int) (color.g * 255),
+				(int) (color.b * 255), (int) (color.a * 255)), lua_type(L, 2) == LUA_TNUMBER);
+	} else if (lua_istable(L, 2)) {
+		lua_getfield(L, 2, "value");
+		if (!nk_love_is_color(L, -1))
+			luaL_argerror(L, 2, "should have a color value");
+		struct nk_colorf color = nk_love_checkcolorf(L, -1);
+		int changed = nk_color_pick(&context->nkctx, &color, format);
+		if (changed) {
+			struct nk_color new_color = nk_rgba((int) (color.r * 255), (int) (color.g * 255),
+					(int) (color.b * 255), (int) (color.a * 255));
+			if (lua_istable(L, -1)) {
+				lua_pushnumber(L, new_color.r);
+				lua_rawseti(L, -2, 1);
+				lua_pushnumber(L, new_color.g);
+				lua_rawseti(L, -2, 2);
+				lua_pushnumber(L, new_color.b);
+				lua_rawseti(L, -2, 3);
+				lua_pushnumber(L, new_color.a);
+				lua_rawseti(L, -2, 4);
+			} else {
+				nk_love_pushcolor(L, new_color, lua_type(L, -1) == LUA_TNUMBER);
+				lua_setfield(L, 2, "value");
+			}
+		}
+		lua_pushboolean(L, changed);
+	} else {
+		luaL_typerror(L, 2, "color or table");
+	}
+	return 1;
 }
 
-static int nk_love_layout_space_to_local(lua_State *L)
+static int nk_love_property(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 3);
+	nk_love_assert_argc(L, lua_gettop(L) == 7);
 	nk_love_assert_context(L, 1);
-	struct nk_vec2 screen;
-	screen.x = luaL_checknumber(L, 2);
-	screen.y = luaL_checknumber(L, 3);
-	struct nk_vec2 local = nk_layout_space_to_local(&context->nkctx, screen);
-	lua_pushnumber(L, local.x);
-	lua_pushnumber(L, local.y);
-	return 2;
+	const char *name = luaL_checkstring(L, 2);
+	double min = luaL_checknumber(L, 3);
+	double max = luaL_checknumber(L, 5);
+	double step = luaL_checknumber(L, 6);
+	float inc_per_pixel = luaL_checknumber(L, 7);
+	if (lua_isnumber(L, 4)) {
+		double value = lua_tonumber(L, 4);
+		value = nk_propertyd(&context->nkctx, name, min, value, max, step, inc_per_pixel);
+		lua_pushnumber(L, value);
+	} else if (lua_istable(L, 4)) {
+		lua_getfield(L, 4, "value");
+		if (!lua_isnumber(L, -1))
+			luaL_argerror(L, 4, "should have a number value");
+		double value = lua_tonumber(L, -1);
+		double old = value;
+		nk_property_double(&context->nkctx, name, min, &value, max, step, inc_per_pixel);
+		int changed = value != old;
+		if (changed) {
+			lua_pushnumber(L, value);
+			lua_setfield(L, 4, "value");
+		}
+		lua_pushboolean(L, changed);
+	} else {
+		luaL_typerror(L, 4, "number or table");
+	}
+	return 1;
 }
 
-static int nk_love_layout_space_rect_to_screen(lua_State *L)
+static struct nk_love_text_buffer *nk_love_totextbuffer(lua_State *L, int index)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 5);
-	nk_love_assert_context(L, 1);
-	struct nk_rect local;
-	local.x = luaL_checknumber(L, 2);
-	local.y = luaL_checknumber(L, 3);
-	local.w = luaL_checknumber(L, 4);
-	local.h = luaL_checknumber(L, 5);
-	struct nk_rect screen = nk_layout_space_rect_to_screen(&context->nkctx, local);
-	lua_pushnumber(L, screen.x);
-	lua_pushnumber(L, screen.y);
-	lua_pushnumber(L, screen.w);
-	lua_pushnumber(L, screen.h);
-	return 4;
+	return nk_love_toudata(L, index, "textbuffer");
 }
 
-static int nk_love_layout_space_rect_to_local(lua_State *L)
+static struct nk_love_text_buffer *nk_love_checktextbuffer(lua_State *L, int index)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 5);
-	nk_love_assert_context(L, 1);
-	struct nk_rect screen;
-	screen.x = luaL_checknumber(L, 2);
-	screen.y = luaL_checknumber(L, 3);
-	screen.w = luaL_checknumber(L, 4);
-	screen.h = luaL_checknumber(L, 5);
-	struct nk_rect local = nk_layout_space_rect_to_screen(&context->nkctx, screen);
-	lua_pushnumber(L, local.x);
-	lua_pushnumber(L, local.y);
-	lua_pushnumber(L, local.w);
-	lua_pushnumber(L, local.h);
-	return 4;
+	struct nk_love_text_buffer *buffer = nk_love_totextbuffer(L, index);
+	if (buffer == NULL)
+		luaL_typerror(L, index, "TextBuffer");
+	return buffer;
 }
 
-static int nk_love_layout_ratio_from_pixel(lua_State *L)
+/*
+ * Text only changes by typing, pasting, deleting, undo or redo. Typing and
+ * pasting set edit_changed, deleting changes the length, and undo and redo
+ * move the undo points, so comparing these detects edits without reading
+ * the text.
+ */
+static void nk_love_text_buffer_mark(struct nk_love_text_buffer *buffer)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_context(L, 1);
-	float pixel_width = luaL_checknumber(L, 2);
-	float ratio = nk_layout_ratio_from_pixel(&context->nkctx, pixel_width);
-	lua_pushnumber(L, ratio);
-	return 1;
+	buffer->length = nk_str_len_char(&buffer->edit.string);
+	buffer->undo_point = buffer->edit.undo.undo_point;
+	buffer->redo_point = buffer->edit.undo.redo_point;
 }
 
-/*
- * ===============================================================
- *
- *                          WIDGETS
- *
- * ===============================================================
- */
+static int nk_love_text_buffer_changed(struct nk_love_text_buffer *buffer)
+{
+	return buffer->length != nk_str_len_char(&buffer->edit.string)
+		|| buffer->undo_point != buffer->edit.undo.undo_point
+		|| buffer->redo_point != buffer->edit.undo.redo_point;
+}
 
-static int nk_love_group_begin(lua_State *L)
+static nk_bool nk_love_filter_edit(const struct nk_text_edit *edit, nk_rune unicode)
 {
-	nk_love_assert_argc(L, lua_gettop(L) >= 2);
-	nk_love_assert_context(L, 1);
-	const char *title = luaL_checkstring(L, 2);
-	nk_flags flags = nk_love_parse_window_flags(L, 3, lua_gettop(L));
-	int open = nk_group_begin(&context->nkctx, title, flags);
-	lua_pushboolean(L, open);
-	return 1;
+	context->edit_changed = 1;
+	return nk_filter_default(edit, unicode);
 }
 
-static int nk_love_group_end(lua_State *L)
+static void nk_love_text_buffer_set(struct nk_love_text_buffer *buffer,
+	const char *text, size_t len)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	nk_group_end(&context->nkctx);
-	return 0;
+	nk_textedit_init_default(&buffer->edit);
+	nk_str_append_text_char(&buffer->edit.string, text, len);
+	nk_love_text_buffer_mark(buffer);
 }
 
-static int nk_love_group(lua_State *L)
+static void nk_love_push_edit_event(lua_State *L, nk_flags event)
 {
-	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
-	nk_love_assert_argc(L, lua_gettop(L) >= 3);
-	if (!lua_isfunction(L, -1))
-		luaL_typerror(L, lua_gettop(L), "function");
-	lua_pushvalue(L, 1);
-	lua_insert(L, 2);
-	lua_pushvalue(L, 1);
-	lua_insert(L, 3);
-	lua_insert(L, 2);
-	lua_getfield(L, 1, "groupBegin");
-	lua_insert(L, 4);
-	lua_call(L, lua_gettop(L) - 4, 1);
-	int open = lua_toboolean(L, -1);
-	lua_pop(L, 1);
-	if (open) {
-		lua_call(L, 1, 0);
-		lua_getfield(L, 1, "groupEnd");
-		lua_insert(L, 1);
-		lua_call(L, 1, 0);
-	} else {
-		lua_pop(L, 3);
-	}
-	return 0;
+	if (event & NK_EDIT_COMMITED)
+		lua_pushstring(L, "commited");
+	else if (event & NK_EDIT_ACTIVATED)
+		lua_pushstring(L, "activated");
+	else if (event & NK_EDIT_DEACTIVATED)
+		lua_pushstring(L, "deactivated");
+	else if (event & NK_EDIT_ACTIVE)
+		lua_pushstring(L, "active");
+	else if (event & NK_EDIT_INACTIVE)
+		lua_pushstring(L, "inactive");
+	else
+		lua_pushnil(L);
 }
 
-static int nk_love_group_get_scroll(lua_State *L)
+static int nk_love_edit(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_assert_argc(L, lua_gettop(L) == 3);
 	nk_love_assert_context(L, 1);
-	const char *id = luaL_checkstring(L, 2);
-	nk_uint x_offset, y_offset;
-	nk_group_get_scroll(&context->nkctx, id, &x_offset, &y_offset);
-	lua_pushinteger(L, x_offset);
-	lua_pushinteger(L, y_offset);
+	nk_flags flags = nk_love_checkedittype(L, 2);
+	struct nk_love_text_buffer *buffer = nk_love_totextbuffer(L, 3);
+	if (buffer != NULL) {
+		context->edit_changed = 0;
+		nk_flags event = nk_edit_buffer(&context->nkctx, flags, &buffer->edit, nk_love_filter_edit);
+		int changed = context->edit_changed || nk_love_text_buffer_changed(buffer);
+		if (changed) {
+			nk_love_text_buffer_mark(buffer);
+			buffer->version++;
+		}
+		nk_love_push_edit_event(L, event);
+		lua_pushboolean(L, changed);
+		return 2;
+	}
+	if (!lua_istable(L, 3))
+		luaL_typerror(L, 3, "table or TextBuffer");
+	lua_getfield(L, 3, "value");
+	if (!lua_isstring(L, -1))
+		luaL_argerror(L, 3, "should have a string value");
+	const char *value = lua_tostring(L, -1);
+	size_t len = strlen(value);
+	size_t max = len + NK_MAX(len, NK_LOVE_EDIT_SLACK);
+	char *edit_buffer = nk_love_arena_alloc(L, max + 1);
+	memcpy(edit_buffer, value, len);
+	edit_buffer[len] = '\0';
+	nk_flags event = nk_edit_string_zero_terminated(&context->nkctx, flags, edit_buffer, max, nk_filter_default);
+	lua_pushstring(L, edit_buffer);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, 3, "value");
+	int changed = !lua_equal(L, -1, -2);
+	nk_love_push_edit_event(L, event);
+	lua_pushboolean(L, changed);
 	return 2;
 }
 
-static int nk_love_group_set_scroll(lua_State *L)
+static int nk_love_new_text_buffer(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 4);
-	nk_love_assert_context(L, 1);
-	const char *id = luaL_checkstring(L, 2);
-	nk_uint x_offset = luaL_checkint(L, 3);
-	nk_uint y_offset = luaL_checkint(L, 4);
-	nk_group_set_scroll(&context->nkctx, id, x_offset, y_offset);
+	nk_love_assert_argc(L, lua_gettop(L) >= 1 && lua_gettop(L) <= 2);
+	nk_love_checkcontext(L, 1);
+	size_t len = 0;
+	const char *text = luaL_optlstring(L, 2, "", &len);
+	struct nk_love_text_buffer *buffer = lua_newuserdata(L, sizeof(struct nk_love_text_buffer));
+	nk_love_assert_alloc(L, buffer);
+	nk_love_text_buffer_set(buffer, text, len);
+	buffer->version = 0;
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_getfield(L, -1, "textbuffer");
+	lua_setmetatable(L, -3);
+	lua_pop(L, 1);
+	return 1;
+}
+
+static int nk_love_text_buffer_get_text(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_text_buffer *buffer = nk_love_checktextbuffer(L, 1);
+	struct nk_str *string = &buffer->edit.string;
+	lua_pushlstring(L, nk_str_get_const(string), nk_str_len_char(string));
+	return 1;
+}
+
+static int nk_love_text_buffer_set_text(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_text_buffer *buffer = nk_love_checktextbuffer(L, 1);
+	size_t len;
+	const char *text = luaL_checklstring(L, 2, &len);
+	nk_textedit_free(&buffer->edit);
+	nk_love_text_buffer_set(buffer, text, len);
+	buffer->version++;
 	return 0;
 }
 
-static int nk_love_tree_push(lua_State *L)
+static int nk_love_text_buffer_get_length(lua_State *L)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc >= 3 && argc <= 5);
-	nk_love_assert_context(L, 1);
-	enum nk_tree_type type = nk_love_checktree(L, 2);
-	const char *title = luaL_checkstring(L, 3);
-	struct nk_image image;
-	int use_image = 0;
-	if (argc >= 4 && !lua_isnil(L, 4)) {
-		nk_love_checkImage(L, 4, &image);
-		use_image = 1;
-	}
-	enum nk_collapse_states state = NK_MINIMIZED;
-	if (argc >= 5 && !lua_isnil(L, 5))
-		state = nk_love_checkstate(L, 5);
-	lua_Debug ar;
-	lua_getstack(L, 1, &ar);
-	lua_getinfo(L, "l", &ar);
-	int id = ar.currentline;
-	int open = 0;
-	if (use_image)
-		open = nk_tree_image_push_hashed(&context->nkctx, type, image, title, state, title, strlen(title), id);
-	else
-		open = nk_tree_push_hashed(&context->nkctx, type, title, state, title, strlen(title), id);
-	lua_pushboolean(L, open);
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_text_buffer *buffer = nk_love_checktextbuffer(L, 1);
+	lua_pushnumber(L, nk_str_len_char(&buffer->edit.string));
 	return 1;
 }
 
-static int nk_love_tree_pop(lua_State *L)
+static int nk_love_text_buffer_get_version(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	nk_tree_pop(&context->nkctx);
-	return 0;
+	struct nk_love_text_buffer *buffer = nk_love_checktextbuffer(L, 1);
+	lua_pushnumber(L, buffer->version);
+	return 1;
 }
 
-static int nk_love_tree(lua_State *L)
+static int nk_love_text_buffer_gc(lua_State *L)
 {
-	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
-	nk_love_assert_argc(L, lua_gettop(L) >= 4);
-	if (!lua_isfunction(L, -1))
-		luaL_typerror(L, lua_gettop(L), "function");
-	lua_pushvalue(L, 1);
-	lua_insert(L, 2);
-	lua_pushvalue(L, 1);
-	lua_insert(L, 3);
-	lua_insert(L, 2);
-	lua_getfield(L, 1, "treePush");
-	lua_insert(L, 4);
-	lua_call(L, lua_gettop(L) - 4, 1);
-	int open = lua_toboolean(L, -1);
-	lua_pop(L, 1);
-	if (open) {
-		lua_call(L, 1, 0);
-		lua_getfield(L, 1, "treePop");
-		lua_insert(L, 1);
-		lua_call(L, 1, 0);
-	}
+	struct nk_love_text_buffer *buffer = lua_touserdata(L, 1);
+	nk_textedit_free(&buffer->edit);
 	return 0;
 }
 
-static int nk_love_tree_state_push(lua_State *L)
+static struct nk_love_document *nk_love_checkdocument(lua_State *L, int index)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc >= 3 && argc <= 5);
-	nk_love_assert_context(L, 1);
-	enum nk_tree_type type = nk_love_checktree(L, 2);
-	const char *title = luaL_checkstring(L, 3);
-	struct nk_image image;
-	int use_image = 0;
-	if (argc >= 4 && !lua_isnil(L, 4)) {
-		nk_love_checkImage(L, 4, &image);
-		use_image = 1;
-	}
-	enum nk_collapse_states state = NK_MINIMIZED;
-	if (argc >= 5)
-		state = nk_love_checkstate(L, 5);
+	struct nk_love_document *doc = nk_love_toudata(L, index, "document");
+	if (doc == NULL)
+		luaL_typerror(L, index, "Document");
+	return doc;
+}
 
-	int open = 0;
-	if (use_image)
-		open = nk_tree_state_image_push(&context->nkctx, type, image, title, &state);
-	else
-		open = nk_tree_state_push(&context->nkctx, type, title, &state);
-	lua_pushboolean(L, open);
-	return 1;
+static size_t nk_love_document_length(const struct nk_love_document *doc)
+{
+	return doc->capacity - (doc->gap_end - doc->gap_start);
 }
 
-static int nk_love_tree_state_pop(lua_State *L)
+static char nk_love_document_char(const struct nk_love_document *doc, size_t pos)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	nk_tree_state_pop(&context->nkctx);
-	return 0;
+	if (pos >= doc->gap_start)
+		pos += doc->gap_end - doc->gap_start;
+	return doc->text[pos];
 }
 
-static int nk_love_tree_state(lua_State *L)
+static size_t nk_love_document_line_count(const struct nk_love_document *doc)
 {
-	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
-	nk_love_assert_argc(L, lua_gettop(L) >= 4);
-	if (!lua_isfunction(L, -1))
-		luaL_typerror(L, lua_gettop(L), "function");
-	lua_pushvalue(L, 1);
-	lua_insert(L, 2);
-	lua_pushvalue(L, 1);
-	lua_insert(L, 3);
-	lua_insert(L, 2);
-	lua_getfield(L, 1, "treeStatePush");
-	lua_insert(L, 4);
-	lua_call(L, lua_gettop(L) - 4, 1);
-	int open = lua_toboolean(L, -1);
-	lua_pop(L, 1);
-	if (open) {
-		lua_call(L, 1, 0);
-		lua_getfield(L, 1, "treeStatePop");
-		lua_insert(L, 1);
-		lua_call(L, 1, 0);
-	}
-	return 0;
+	return doc->line_capacity - (doc->line_gap_end - doc->line_gap_start);
 }
 
-static int nk_love_color_rgba(lua_State *L)
+static size_t nk_love_document_line_start(const struct nk_love_document *doc, size_t line)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc == 3 || argc == 4);
-	int r = luaL_checkint(L, 1);
-	int g = luaL_checkint(L, 2);
-	int b = luaL_checkint(L, 3);
-	int a = 255;
-	if (argc == 4)
-		a = luaL_checkint(L, 4);
-	char color_string[10];
-	nk_love_color(r, g, b, a, color_string);
-	lua_pushstring(L, color_string);
-	return 1;
+	if (line < doc->line_gap_start)
+		return doc->lines[line];
+	line += doc->line_gap_end - doc->line_gap_start;
+	return nk_love_document_length(doc) - doc->lines[line];
 }
 
-static int nk_love_color_hsva(lua_State *L)
+static size_t nk_love_document_line_end(const struct nk_love_document *doc, size_t line)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc == 3 || argc == 4);
-	int h = NK_CLAMP(0, luaL_checkint(L, 1), 255);
-	int s = NK_CLAMP(0, luaL_checkint(L, 2), 255);
-	int v = NK_CLAMP(0, luaL_checkint(L, 3), 255);
-	int a = 255;
-	if (argc == 4)
-		a = NK_CLAMP(0, luaL_checkint(L, 4), 255);
-	struct nk_color rgba = nk_hsva(h, s, v, a);
-	char color_string[10];
-	nk_love_color(rgba.r, rgba.g, rgba.b, rgba.a, color_string);
-	lua_pushstring(L, color_string);
-	return 1;
+	if (line + 1 < nk_love_document_line_count(doc))
+		return nk_love_document_line_start(doc, line + 1) - 1;
+	return nk_love_document_length(doc);
 }
 
-static int nk_love_color_parse_rgba(lua_State *L)
+static size_t nk_love_document_line_of(const struct nk_love_document *doc, size_t pos)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	struct nk_color rgba = nk_love_checkcolor(L, 1);
-	lua_pushnumber(L, rgba.r);
-	lua_pushnumber(L, rgba.g);
-	lua_pushnumber(L, rgba.b);
-	lua_pushnumber(L, rgba.a);
-	return 4;
+	size_t lo = 0, hi = nk_love_document_line_count(doc);
+	while (hi - lo > 1) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (nk_love_document_line_start(doc, mid) <= pos)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return lo;
 }
 
-static int nk_love_color_parse_hsva(lua_State *L)
+static size_t nk_love_document_prev(const struct nk_love_document *doc, size_t pos)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	struct nk_color rgba = nk_love_checkcolor(L, 1);
-	int h, s, v, a2;
-	nk_color_hsva_i(&h, &s, &v, &a2, rgba);
-	lua_pushnumber(L, h);
-	lua_pushnumber(L, s);
-	lua_pushnumber(L, v);
-	lua_pushnumber(L, a2);
-	return 4;
+	while (pos > 0 && (nk_love_document_char(doc, --pos) & 0xC0) == 0x80);
+	return pos;
 }
 
-static int nk_love_label(lua_State *L)
+static size_t nk_love_document_next(const struct nk_love_document *doc, size_t pos)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc >= 2 && argc <= 4);
-	nk_love_assert_context(L, 1);
-	const char *text = luaL_checkstring(L, 2);
-	nk_flags align = NK_TEXT_LEFT;
-	int wrap = 0;
-	struct nk_color color;
-	int use_color = 0;
-	if (argc >= 3) {
-		const char *align_string = luaL_checkstring(L, 3);
-		if (!strcmp(align_string, "wrap"))
-			wrap = 1;
-		else
-			align = nk_love_checkalign(L, 3);
-		if (argc >= 4) {
-			color = nk_love_checkcolor(L, 4);
-			use_color = 1;
-		}
-	}
-	if (use_color) {
-		if (wrap)
-			nk_label_colored_wrap(&context->nkctx, text, color);
-		else
-			nk_label_colored(&context->nkctx, text, align, color);
-	} else {
-		if (wrap)
-			nk_label_wrap(&context->nkctx, text);
-		else
-			nk_label(&context->nkctx, text, align);
-	}
-	return 0;
+	size_t len = nk_love_document_length(doc);
+	if (pos < len)
+		while (++pos < len && (nk_love_document_char(doc, pos) & 0xC0) == 0x80);
+	return pos;
 }
 
-static int nk_love_image(lua_State *L)
+static const char *nk_love_document_span(lua_State *L, struct nk_love_document *doc,
+	size_t start, size_t end)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc == 2 || argc == 6);
-	nk_love_assert_context(L, 1);
-	struct nk_image image;
-	nk_love_checkImage(L, 2, &image);
-	if (argc == 2) {
-		nk_image(&context->nkctx, image);
-	} else {
-		float x = luaL_checknumber(L, 3);
-		float y = luaL_checknumber(L, 4);
-		float w = luaL_checknumber(L, 5);
-		float h = luaL_checknumber(L, 6);
-		float line_thickness;
-		struct nk_color color;
-		nk_love_getGraphics(L, &line_thickness, &color);
-		nk_draw_image(&context->nkctx.current->buffer, nk_rect(x, y, w, h), &image, color);
+	if (end <= doc->gap_start)
+		return doc->text + start;
+	if (start >= doc->gap_start)
+		return doc->text + start + (doc->gap_end - doc->gap_start);
+	if (end - start > doc->scratch_capacity) {
+		char *scratch = realloc(doc->scratch, end - start);
+		nk_love_assert_alloc(L, scratch);
+		doc->scratch = scratch;
+		doc->scratch_capacity = end - start;
+	}
+	memcpy(doc->scratch, doc->text + start, doc->gap_start - start);
+	memcpy(doc->scratch + (doc->gap_start - start), doc->text + doc->gap_end, end - doc->gap_start);
+	return doc->scratch;
+}
+
+static void nk_love_document_move_gap(struct nk_love_document *doc, size_t pos)
+{
+	size_t len = nk_love_document_length(doc);
+	if (pos < doc->gap_start) {
+		size_t n = doc->gap_start - pos;
+		memmove(doc->text + doc->gap_end - n, doc->text + pos, n);
+		doc->gap_start -= n;
+		doc->gap_end -= n;
+	} else if (pos > doc->gap_start) {
+		size_t n = pos - doc->gap_start;
+		memmove(doc->text + doc->gap_start, doc->text + doc->gap_end, n);
+		doc->gap_start += n;
+		doc->gap_end += n;
+	}
+	while (doc->line_gap_start > 1 && doc->lines[doc->line_gap_start - 1] > pos) {
+		doc->line_gap_start--;
+		doc->line_gap_end--;
+		doc->lines[doc->line_gap_end] = len - doc->lines[doc->line_gap_start];
+	}
+	while (doc->line_gap_end < doc->line_capacity && len - doc->lines[doc->line_gap_end] <= pos) {
+		doc->lines[doc->line_gap_start] = len - doc->lines[doc->line_gap_end];
+		doc->line_gap_start++;
+		doc->line_gap_end++;
 	}
-	return 0;
 }
 
-static int nk_love_button(lua_State *L)
+static void nk_love_document_reserve(lua_State *L, struct nk_love_document *doc,
+	size_t len, size_t lines)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc >= 2 && argc <= 3);
-	nk_love_assert_context(L, 1);
-	const char *title = NULL;
-	if (!lua_isnil(L, 2))
-		title = luaL_checkstring(L, 2);
-	int use_color = 0, use_image = 0;
-	struct nk_color color;
-	enum nk_symbol_type symbol = NK_SYMBOL_NONE;
-	struct nk_image image;
-	if (argc >= 3 && !lua_isnil(L, 3)) {
-		if (lua_isstring(L, 3)) {
-			if (nk_love_is_color(L, 3)) {
-				color = nk_love_checkcolor(L, 3);
-				use_color = 1;
-			} else {
-				symbol = nk_love_checksymbol(L, 3);
-			}
-		} else {
-			nk_love_checkImage(L, 3, &image);
-			use_image = 1;
-		}
+	if (doc->gap_end - doc->gap_start < len) {
+		size_t tail = doc->capacity - doc->gap_end;
+		size_t capacity = NK_MAX(doc->capacity * 2, doc->capacity + len + NK_LOVE_DOCUMENT_GAP);
+		char *text = realloc(doc->text, capacity);
+		nk_love_assert_alloc(L, text);
+		memmove(text + capacity - tail, text + doc->gap_end, tail);
+		doc->text = text;
+		doc->gap_end = capacity - tail;
+		doc->capacity = capacity;
 	}
-	nk_flags align = context->nkctx.style.button.text_alignment;
-	int activated = 0;
-	if (title != NULL) {
-		if (use_color)
-			nk_love_assert(L, 0, "%s: color buttons can't have titles");
-		else if (symbol != NK_SYMBOL_NONE)
-			activated = nk_button_symbol_label(&context->nkctx, symbol, title, align);
-		else if (use_image)
-			activated = nk_button_image_label(&context->nkctx, image, title, align);
-		else
-			activated = nk_button_label(&context->nkctx, title);
-	} else {
-		if (use_color)
-			activated = nk_button_color(&context->nkctx, color);
-		else if (symbol != NK_SYMBOL_NONE)
-			activated = nk_button_symbol(&context->nkctx, symbol);
-		else if (use_image)
-			activated = nk_button_image(&context->nkctx, image);
-		else
-			nk_love_assert(L, 0, "%s: must specify a title, color, symbol, and/or image");
+	if (doc->line_gap_end - doc->line_gap_start < lines) {
+		size_t tail = doc->line_capacity - doc->line_gap_end;
+		size_t capacity = NK_MAX(doc->line_capacity * 2, doc->line_capacity + lines + NK_LOVE_DOCUMENT_LINE_GAP);
+		size_t *starts = realloc(doc->lines, capacity * sizeof(size_t));
+		nk_love_assert_alloc(L, starts);
+		memmove(starts + capacity - tail, starts + doc->line_gap_end, tail * sizeof(size_t));
+		doc->lines = starts;
+		doc->line_gap_end = capacity - tail;
+		doc->line_capacity = capacity;
 	}
-	lua_pushboolean(L, activated);
-	return 1;
 }
 
-static int nk_love_button_set_behavior(lua_State *L)
+static void nk_love_document_insert(lua_State *L, struct nk_love_document *doc,
+	size_t pos, const char *text, size_t len)
+{
+	size_t i, lines = 0;
+	for (i = 0; i < len; ++i)
+		lines += text[i] == '\n';
+	nk_love_document_reserve(L, doc, len, lines);
+	nk_love_document_move_gap(doc, pos);
+	memcpy(doc->text + pos, text, len);
+	doc->gap_start += len;
+	for (i = 0; i < len; ++i)
+		if (text[i] == '\n')
+			doc->lines[doc->line_gap_start++] = pos + i + 1;
+	doc->version++;
+}
+
+static void nk_love_document_erase(struct nk_love_document *doc, size_t start, size_t end)
+{
+	nk_love_document_move_gap(doc, end);
+	while (doc->line_gap_start > 1 && doc->lines[doc->line_gap_start - 1] > start)
+		doc->line_gap_start--;
+	doc->gap_start = start;
+	doc->version++;
+}
+
+static size_t nk_love_document_hit(lua_State *L, struct nk_love_document *doc,
+	const struct nk_user_font *font, size_t line, float x)
+{
+	size_t start = nk_love_document_line_start(doc, line);
+	size_t len = nk_love_document_line_end(doc, line) - start;
+	const char *text = nk_love_document_span(L, doc, start, start + len);
+	size_t i = 0;
+	float left = 0;
+	while (i < len) {
+		nk_rune unicode;
+		int glyph_len = nk_utf_decode(text + i, &unicode, (int)(len - i));
+		if (glyph_len == 0)
+			glyph_len = 1;
+		float width = font->width(font->userdata, font->height, text + i, glyph_len);
+		if (left + width / 2 > x)
+			break;
+		left += width;
+		i += glyph_len;
+	}
+	return start + i;
+}
+
+static float nk_love_document_column(lua_State *L, struct nk_love_document *doc,
+	const struct nk_user_font *font, size_t pos)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_context(L, 1);
-	enum nk_button_behavior behavior = nk_love_checkbehavior(L, 2);
-	nk_button_set_behavior(&context->nkctx, behavior);
-	return 0;
+	size_t start = nk_love_document_line_start(doc, nk_love_document_line_of(doc, pos));
+	const char *text = nk_love_document_span(L, doc, start, pos);
+	return font->width(font->userdata, font->height, text, (int)(pos - start));
 }
 
-static int nk_love_button_push_behavior(lua_State *L)
+static void nk_love_document_selection(const struct nk_love_document *doc,
+	size_t *start, size_t *end)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
-	nk_love_assert_context(L, 1);
-	enum nk_button_behavior behavior = nk_love_checkbehavior(L, 2);
-	nk_button_push_behavior(&context->nkctx, behavior);
-	return 0;
+	*start = NK_MIN(doc->anchor, doc->cursor);
+	*end = NK_MAX(doc->anchor, doc->cursor);
 }
 
-static int nk_love_button_pop_behavior(lua_State *L)
+static void nk_love_document_copy(lua_State *L, struct nk_love_document *doc)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
-	nk_love_assert_context(L, 1);
-	nk_button_pop_behavior(&context->nkctx);
-	return 0;
+	size_t start, end;
+	nk_love_document_selection(doc, &start, &end);
+	if (start == end)
+		return;
+	const char *text = nk_love_document_span(L, doc, start, end);
+	lua_getglobal(L, "love");
+	lua_getfield(L, -1, "system");
+	lua_getfield(L, -1, "setClipboardText");
+	lua_pushlstring(L, text, end - start);
+	lua_call(L, 1, 0);
+	lua_pop(L, 2);
 }
 
-static int nk_love_checkbox(lua_State *L)
+static int nk_love_document_erase_selection(struct nk_love_document *doc)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 3);
-	nk_love_assert_context(L, 1);
-	const char *text = luaL_checkstring(L, 2);
-	if (lua_isboolean(L, 3)) {
-		int value = lua_toboolean(L, 3);
-		value = nk_check_label(&context->nkctx, text, value);
-		lua_pushboolean(L, value);
-	} else if (lua_istable(L, 3)) {
-		lua_getfield(L, 3, "value");
-		if (!lua_isboolean(L, -1))
-			luaL_argerror(L, 3, "should have a boolean value");
-		int value = lua_toboolean(L, -1);
-		int changed = nk_checkbox_label(&context->nkctx, text, &value);
-		if (changed) {
-			lua_pushboolean(L, value);
-			lua_setfield(L, 3, "value");
-		}
-		lua_pushboolean(L, changed);
-	} else {
-		luaL_typerror(L, 3, "boolean or table");
-	}
+	size_t start, end;
+	nk_love_document_selection(doc, &start, &end);
+	if (start == end)
+		return 0;
+	nk_love_document_erase(doc, start, end);
+	doc->cursor = doc->anchor = start;
 	return 1;
 }
 
-static int nk_love_radio(lua_State *L)
+static void nk_love_document_type(lua_State *L, struct nk_love_document *doc,
+	const char *text, size_t len)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc == 3 || argc == 4);
-	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	const char *text = name;
-	if (argc == 4)
-		text = luaL_checkstring(L, 3);
-	if (lua_isstring(L, -1)) {
-		const char *value = lua_tostring(L, -1);
-		int active = !strcmp(value, name);
-		active = nk_option_label(&context->nkctx, text, active);
-		if (active)
-			lua_pushstring(L, name);
-		else
-			lua_pushstring(L, value);
-	} else if (lua_istable(L, -1)) {
-		lua_getfield(L, -1, "value");
-		if (!lua_isstring(L, -1))
-			luaL_argerror(L, argc, "should have a string value");
-		const char *value = lua_tostring(L, -1);
-		int active = !strcmp(value, name);
-		int changed = nk_radio_label(&context->nkctx, text, &active);
-		if (changed && active) {
-			lua_pushstring(L, name);
-			lua_setfield(L, -3, "value");
-		}
-		lua_pushboolean(L, changed);
-	} else {
-		luaL_typerror(L, argc, "string or table");
+	nk_love_document_erase_selection(doc);
+	nk_love_document_insert(L, doc, doc->cursor, text, len);
+	doc->cursor += len;
+	doc->anchor = doc->cursor;
+}
+
+static int nk_love_document_keys(lua_State *L, struct nk_love_document *doc,
+	const struct nk_input *in, const struct nk_user_font *font, size_t rows)
+{
+	size_t cursor = doc->cursor, anchor = doc->anchor;
+	unsigned int version = doc->version;
+	if (nk_input_is_key_pressed(in, NK_KEY_COPY) || nk_input_is_key_pressed(in, NK_KEY_CUT))
+		nk_love_document_copy(L, doc);
+	if (nk_input_is_key_pressed(in, NK_KEY_CUT))
+		nk_love_document_erase_selection(doc);
+	if (in->keyboard.text_len > 0)
+		nk_love_document_type(L, doc, in->keyboard.text, in->keyboard.text_len);
+	if (nk_input_is_key_pressed(in, NK_KEY_ENTER))
+		nk_love_document_type(L, doc, "\n", 1);
+	if (nk_input_is_key_pressed(in, NK_KEY_TAB))
+		nk_love_document_type(L, doc, "\t", 1);
+	if (nk_input_is_key_pressed(in, NK_KEY_PASTE)) {
+		lua_getglobal(L, "love");
+		lua_getfield(L, -1, "system");
+		lua_getfield(L, -1, "getClipboardText");
+		lua_call(L, 0, 1);
+		size_t len;
+		const char *text = lua_tolstring(L, -1, &len);
+		if (text)
+			nk_love_document_type(L, doc, text, len);
+		lua_pop(L, 3);
 	}
-	return 1;
+	if (nk_input_is_key_pressed(in, NK_KEY_BACKSPACE) && !nk_love_document_erase_selection(doc) && doc->cursor > 0) {
+		size_t prev = nk_love_document_prev(doc, doc->cursor);
+		nk_love_document_erase(doc, prev, doc->cursor);
+		doc->cursor = doc->anchor = prev;
+	}
+	if (nk_input_is_key_pressed(in, NK_KEY_DEL) && !nk_love_document_erase_selection(doc) && doc->cursor < nk_love_document_length(doc))
+		nk_love_document_erase(doc, doc->cursor, nk_love_document_next(doc, doc->cursor));
+	size_t moved = doc->cursor;
+	if (nk_input_is_key_pressed(in, NK_KEY_LEFT))
+		doc->cursor = nk_love_document_prev(doc, doc->cursor);
+	if (nk_input_is_key_pressed(in, NK_KEY_RIGHT))
+		doc->cursor = nk_love_document_next(doc, doc->cursor);
+	if (nk_input_is_key_pressed(in, NK_KEY_TEXT_LINE_START))
+		doc->cursor = nk_love_document_line_start(doc, nk_love_document_line_of(doc, doc->cursor));
+	if (nk_input_is_key_pressed(in, NK_KEY_TEXT_LINE_END))
+		doc->cursor = nk_love_document_line_end(doc, nk_love_document_line_of(doc, doc->cursor));
+	size_t line = nk_love_document_line_of(doc, doc->cursor);
+	size_t target = line;
+	if (nk_input_is_key_pressed(in, NK_KEY_UP) && target > 0)
+		target--;
+	if (nk_input_is_key_pressed(in, NK_KEY_DOWN))
+		target++;
+	if (nk_input_is_key_pressed(in, NK_KEY_SCROLL_UP))
+		target = target > rows ? target - rows : 0;
+	if (nk_input_is_key_pressed(in, NK_KEY_SCROLL_DOWN))
+		target += rows;
+	target = NK_MIN(target, nk_love_document_line_count(doc) - 1);
+	if (target != line) {
+		float x = nk_love_document_column(L, doc, font, doc->cursor);
+		doc->cursor = nk_love_document_hit(L, doc, font, target, x);
+	}
+	if (doc->cursor != moved && !nk_input_is_key_down(in, NK_KEY_SHIFT))
+		doc->anchor = doc->cursor;
+	return doc->cursor != cursor || doc->anchor != anchor || doc->version != version;
 }
 
-static int nk_love_selectable(lua_State *L)
+static size_t nk_love_document_line_at(const struct nk_love_document *doc,
+	struct nk_rect area, float row, float y)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc >= 3 && argc <= 5);
+	if (y < area.y)
+		return doc->scroll > 0 ? doc->scroll - 1 : 0;
+	size_t line = doc->scroll + (size_t)((y - area.y) / row);
+	return NK_MIN(line, nk_love_document_line_count(doc) - 1);
+}
+
+static int nk_love_document(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
 	nk_love_assert_context(L, 1);
-	const char *text = luaL_checkstring(L, 2);
-	struct nk_image image;
-	int use_image = 0;
-	if (argc >= 4 && !lua_isnil(L, 3)) {
-		nk_love_checkImage(L, 3, &image);
-		use_image = 1;
+	struct nk_love_document *doc = nk_love_checkdocument(L, 2);
+	struct nk_context *ctx = &context->nkctx;
+	const struct nk_style_edit *style = &ctx->style.edit;
+	const struct nk_user_font *font = ctx->style.font;
+	unsigned int version = doc->version;
+	int was_active = doc->active;
+	struct nk_rect bounds;
+	enum nk_widget_layout_states state = nk_widget(&bounds, ctx);
+	if (state == NK_WIDGET_INVALID) {
+		lua_pushnil(L);
+		lua_pushboolean(L, 0);
+		return 2;
 	}
-	nk_flags align = NK_TEXT_LEFT;
-	if (argc >= 5)
-		align = nk_love_checkalign(L, 4);
-	if (lua_isboolean(L, -1)) {
-		int value = lua_toboolean(L, -1);
-		if (use_image)
-			value = nk_select_image_label(&context->nkctx, image, text, align, value);
-		else
-			value = nk_select_label(&context->nkctx, text, align, value);
-		lua_pushboolean(L, value);
-	} else if (lua_istable(L, -1)) {
-		lua_getfield(L, -1, "value");
-		if (!lua_isboolean(L, -1))
-			luaL_argerror(L, argc, "should have a boolean value");
-		int value = lua_toboolean(L, -1);
-		int changed;
-		if (use_image)
-			changed = nk_selectable_image_label(&context->nkctx, image, text, align, &value);
-		else
-			changed = nk_selectable_label(&context->nkctx, text, align, &value);
-		if (changed) {
-			lua_pushboolean(L, value);
-			lua_setfield(L, -3, "value");
+	struct nk_input *in = &ctx->input;
+	if (state == NK_WIDGET_ROM || (ctx->current->layout->flags & NK_WINDOW_ROM))
+		in = NULL;
+	float row = font->height + style->row_padding;
+	struct nk_rect area = nk_rect(bounds.x + style->padding.x, bounds.y + style->padding.y,
+		NK_MAX(0, bounds.w - 2 * style->padding.x), NK_MAX(0, bounds.h - 2 * style->padding.y));
+	size_t rows = (size_t)NK_MAX(1, area.h / row);
+	size_t count = nk_love_document_line_count(doc);
+	int hovered = in && nk_input_is_mouse_hovering_rect(in, bounds);
+	int follow = 0;
+	if (in && in->mouse.buttons[NK_BUTTON_LEFT].clicked && in->mouse.buttons[NK_BUTTON_LEFT].down) {
+		doc->active = doc->selecting = hovered;
+		if (hovered) {
+			size_t line = nk_love_document_line_at(doc, area, row, in->mouse.pos.y);
+			doc->cursor = nk_love_document_hit(L, doc, font, line, in->mouse.pos.x - area.x);
+			if (!nk_input_is_key_down(in, NK_KEY_SHIFT))
+				doc->anchor = doc->cursor;
+		}
+	} else if (in && doc->selecting && in->mouse.buttons[NK_BUTTON_LEFT].down) {
+		size_t line = nk_love_document_line_at(doc, area, row, in->mouse.pos.y);
+		doc->cursor = nk_love_document_hit(L, doc, font, line, in->mouse.pos.x - area.x);
+		follow = 1;
+	}
+	if (in && !in->mouse.buttons[NK_BUTTON_LEFT].down)
+		doc->selecting = 0;
+	if (hovered && in->mouse.scroll_delta.y != 0) {
+		float scroll = (float)doc->scroll - in->mouse.scroll_delta.y * 3;
+		doc->scroll = (size_t)NK_CLAMP(0, scroll, (float)(count - 1));
+		in->mouse.scroll_delta.y = 0;
+	}
+	if (in && doc->active && nk_love_document_keys(L, doc, in, font, rows))
+		follow = 1;
+	if (follow) {
+		size_t line = nk_love_document_line_of(doc, doc->cursor);
+		if (line < doc->scroll)
+			doc->scroll = line;
+		else if (line >= doc->scroll + rows)
+			doc->scroll = line - rows + 1;
+	}
+	count = nk_love_document_line_count(doc);
+	doc->scroll = NK_MIN(doc->scroll, count - 1);
+
+	struct nk_command_buffer *out = nk_window_get_canvas(ctx);
+	const struct nk_style_item *background = &style->normal;
+	struct nk_color text_color = style->text_normal;
+	if (doc->active) {
+		background = &style->active;
+		text_color = style->text_active;
+	} else if (hovered) {
+		background = &style->hover;
+		text_color = style->text_hover;
+	}
+	if (background->type == NK_STYLE_ITEM_COLOR)
+		nk_fill_rect(out, bounds, style->rounding, background->data.color);
+	nk_stroke_rect(out, bounds, style->rounding, style->border, style->border_color);
+	struct nk_rect old_clip = out->clip;
+	float x0 = NK_MAX(old_clip.x, area.x), y0 = NK_MAX(old_clip.y, area.y);
+	float x1 = NK_MIN(old_clip.x + old_clip.w, area.x + area.w);
+	float y1 = NK_MIN(old_clip.y + old_clip.h, area.y + area.h);
+	nk_push_scissor(out, nk_rect(x0, y0, NK_MAX(0, x1 - x0), NK_MAX(0, y1 - y0)));
+	size_t cursor_line = nk_love_document_line_of(doc, doc->cursor);
+	size_t select_start, select_end;
+	nk_love_document_selection(doc, &select_start, &select_end);
+	size_t line;
+	for (line = doc->scroll; line < count && line <= doc->scroll + rows; ++line) {
+		size_t start = nk_love_document_line_start(doc, line);
+		size_t end = nk_love_document_line_end(doc, line);
+		const char *text = nk_love_document_span(L, doc, start, end);
+		struct nk_rect r = nk_rect(area.x, area.y + (line - doc->scroll) * row, area.w, row);
+		size_t a = NK_CLAMP(start, select_start, end), b = NK_CLAMP(start, select_end, end);
+		if (a == b && (select_end <= start || select_start > end || select_start == select_end)) {
+			nk_draw_text(out, r, text, (int)(end - start), font, nk_rgba(0, 0, 0, 0), text_color);
+		} else {
+			/* The line is drawn in three runs around the selection, which
+			 * covers one extra space for a selected line break. */
+			float xa = font->width(font->userdata, font->height, text, (int)(a - start));
+			float xb = xa + font->width(font->userdata, font->height, text + (a - start), (int)(b - a));
+			float wrap = select_end > end ? font->height / 2 : 0;
+			nk_fill_rect(out, nk_rect(r.x + xa, r.y, xb - xa + wrap, font->height), 0, style->selected_normal);
+			nk_draw_text(out, r, text, (int)(a - start), font, nk_rgba(0, 0, 0, 0), text_color);
+			nk_draw_text(out, nk_rect(r.x + xa, r.y, r.w - xa, r.h), text + (a - start), (int)(b - a),
+				font, nk_rgba(0, 0, 0, 0), style->selected_text_normal);
+			nk_draw_text(out, nk_rect(r.x + xb, r.y, r.w - xb, r.h), text + (b - start), (int)(end - b),
+				font, nk_rgba(0, 0, 0, 0), text_color);
+		}
+		if (doc->active && line == cursor_line) {
+			float x = font->width(font->userdata, font->height, text, (int)(doc->cursor - start));
+			nk_fill_rect(out, nk_rect(area.x + x, r.y, style->cursor_size, font->height), 0, style->cursor_normal);
 		}
-		lua_pushboolean(L, changed);
-	} else {
-		luaL_typerror(L, argc, "boolean or table");
 	}
+	nk_push_scissor(out, old_clip);
+
+	nk_flags event = doc->active ? NK_EDIT_ACTIVE : NK_EDIT_INACTIVE;
+	if (doc->active && !was_active)
+		event |= NK_EDIT_ACTIVATED;
+	else if (!doc->active && was_active)
+		event |= NK_EDIT_DEACTIVATED;
+	nk_love_push_edit_event(L, event);
+	lua_pushboolean(L, doc->version != version);
+	return 2;
+}
+
+static int nk_love_new_document(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 1 && lua_gettop(L) <= 2);
+	nk_love_checkcontext(L, 1);
+	size_t len = 0;
+	const char *text = luaL_optlstring(L, 2, "", &len);
+	struct nk_love_document *doc = lua_newuserdata(L, sizeof(struct nk_love_document));
+	nk_love_assert_alloc(L, doc);
+	memset(doc, 0, sizeof(struct nk_love_document));
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_getfield(L, -1, "document");
+	lua_setmetatable(L, -3);
+	lua_pop(L, 1);
+	doc->text = nk_love_malloc(L, NK_LOVE_DOCUMENT_GAP);
+	doc->capacity = doc->gap_end = NK_LOVE_DOCUMENT_GAP;
+	doc->lines = nk_love_malloc(L, NK_LOVE_DOCUMENT_LINE_GAP * sizeof(size_t));
+	doc->line_capacity = doc->line_gap_end = NK_LOVE_DOCUMENT_LINE_GAP;
+	doc->lines[0] = 0;
+	doc->line_gap_start = 1;
+	nk_love_document_insert(L, doc, 0, text, len);
+	doc->version = 0;
 	return 1;
 }
 
-static int nk_love_slider(lua_State *L)
+static int nk_love_document_get_text(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 5);
-	nk_love_assert_context(L, 1);
-	float min = luaL_checknumber(L, 2);
-	float max = luaL_checknumber(L, 4);
-	float step = luaL_checknumber(L, 5);
-	if (lua_isnumber(L, 3)) {
-		float value = lua_tonumber(L, 3);
-		value = nk_slide_float(&context->nkctx, min, value, max, step);
-		lua_pushnumber(L, value);
-	} else if (lua_istable(L, 3)) {
-		lua_getfield(L, 3, "value");
-		if (!lua_isnumber(L, -1))
-			luaL_argerror(L, 3, "should have a number value");
-		float value = lua_tonumber(L, -1);
-		int changed = nk_slider_float(&context->nkctx, min, &value, max, step);
-		if (changed) {
-			lua_pushnumber(L, value);
-			lua_setfield(L, 3, "value");
-		}
-		lua_pushboolean(L, changed);
-	} else {
-		luaL_typerror(L, 3, "number or table");
-	}
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_document *doc = nk_love_checkdocument(L, 1);
+	lua_pushlstring(L, doc->text, doc->gap_start);
+	lua_pushlstring(L, doc->text + doc->gap_end, doc->capacity - doc->gap_end);
+	lua_concat(L, 2);
 	return 1;
 }
 
-static int nk_love_progress(lua_State *L)
+static int nk_love_document_set_text(lua_State *L)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc >= 3 || argc <= 4);
-	nk_love_assert_context(L, 1);
-	nk_size max = luaL_checklong(L, 3);
-	int modifiable = 0;
-	if (argc >= 4 && !lua_isnil(L, 4))
-		modifiable = nk_love_checkboolean(L, 4);
-	if (lua_isnumber(L, 2)) {
-		nk_size value = lua_tonumber(L, 2);
-		value = nk_prog(&context->nkctx, value, max, modifiable);
-		lua_pushnumber(L, value);
-	} else if (lua_istable(L, 2)) {
-		lua_getfield(L, 2, "value");
-		if (!lua_isnumber(L, -1))
-			luaL_argerror(L, 2, "should have a number value");
-		nk_size value = (nk_size) lua_tonumber(L, -1);
-		int changed = nk_progress(&context->nkctx, &value, max, modifiable);
-		if (changed) {
-			lua_pushnumber(L, value);
-			lua_setfield(L, 2, "value");
-		}
-		lua_pushboolean(L, changed);
-	} else {
-		luaL_typerror(L, 2, "number or table");
-	}
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_document *doc = nk_love_checkdocument(L, 1);
+	size_t len;
+	const char *text = luaL_checklstring(L, 2, &len);
+	nk_love_document_erase(doc, 0, nk_love_document_length(doc));
+	nk_love_document_insert(L, doc, 0, text, len);
+	doc->cursor = doc->anchor = doc->scroll = 0;
+	return 0;
+}
+
+static int nk_love_document_get_length(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_document *doc = nk_love_checkdocument(L, 1);
+	lua_pushnumber(L, nk_love_document_length(doc));
 	return 1;
 }
 
-static int nk_love_color_picker(lua_State *L)
+static int nk_love_document_get_line_count(lua_State *L)
 {
-	int argc = lua_gettop(L);
-	nk_love_assert_argc(L, argc >= 2 && argc <= 3);
-	nk_love_assert_context(L, 1);
-	enum nk_color_format format = NK_RGB;
-	if (argc >= 3)
-		format = nk_love_checkcolorformat(L, 3);
-	if (lua_isstring(L, 2)) {
-		struct nk_colorf color = nk_love_checkcolorf(L, 2);
-		color = nk_color_picker(&context->nkctx, color, format);
-		char new_color_string[10];
-		nk_love_color((int) (color.r * 255), (int) (color.g * 255),
-				(int) (color.b * 255), (int) (color.a * 255), new_color_string);
-		lua_pushstring(L, new_color_string);
-	} else if (lua_istable(L, 2)) {
-		lua_getfield(L, 2, "value");
-		if (!nk_love_is_color(L, -1))
-			luaL_argerror(L, 2, "should have a color string value");
-		struct nk_colorf color = nk_love_checkcolorf(L, -1);
-		int changed = nk_color_pick(&context->nkctx, &color, format);
-		if (changed) {
-			char new_color_string[10];
-			nk_love_color((int) (color.r * 255), (int) (color.g * 255),
-					(int) (color.b * 255), (int) (color.a * 255), new_color_string);
-			lua_pushstring(L, new_color_string);
-			lua_setfield(L, 2, "value");
-		}
-		lua_pushboolean(L, changed);
-	} else {
-		luaL_typerror(L, 2, "string or table");
-	}
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_document *doc = nk_love_checkdocument(L, 1);
+	lua_pushnumber(L, nk_love_document_line_count(doc));
 	return 1;
 }
 
-static int nk_love_property(lua_State *L)
+static int nk_love_document_get_line(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 7);
-	nk_love_assert_context(L, 1);
-	const char *name = luaL_checkstring(L, 2);
-	double min = luaL_checknumber(L, 3);
-	double max = luaL_checknumber(L, 5);
-	double step = luaL_checknumber(L, 6);
-	float inc_per_pixel = luaL_checknumber(L, 7);
-	if (lua_isnumber(L, 4)) {
-		double value = lua_tonumber(L, 4);
-		value = nk_propertyd(&context->nkctx, name, min, value, max, step, inc_per_pixel);
-		lua_pushnumber(L, value);
-	} else if (lua_istable(L, 4)) {
-		lua_getfield(L, 4, "value");
-		if (!lua_isnumber(L, -1))
-			luaL_argerror(L, 4, "should have a number value");
-		double value = lua_tonumber(L, -1);
-		double old = value;
-		nk_property_double(&context->nkctx, name, min, &value, max, step, inc_per_pixel);
-		int changed = value != old;
-		if (changed) {
-			lua_pushnumber(L, value);
-			lua_setfield(L, 4, "value");
-		}
-		lua_pushboolean(L, changed);
-	} else {
-		luaL_typerror(L, 4, "number or table");
-	}
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_document *doc = nk_love_checkdocument(L, 1);
+	lua_Integer line = luaL_checkinteger(L, 2);
+	luaL_argcheck(L, line >= 1 && (size_t)line <= nk_love_document_line_count(doc), 2, "line out of range");
+	size_t start = nk_love_document_line_start(doc, line - 1);
+	size_t end = nk_love_document_line_end(doc, line - 1);
+	lua_pushlstring(L, nk_love_document_span(L, doc, start, end), end - start);
 	return 1;
 }
 
-static int nk_love_edit(lua_State *L)
+static int nk_love_document_get_version(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 3);
-	nk_love_assert_context(L, 1);
-	nk_flags flags = nk_love_checkedittype(L, 2);
-	if (!lua_istable(L, 3))
-		luaL_typerror(L, 3, "table");
-	lua_getfield(L, 3, "value");
-	if (!lua_isstring(L, -1))
-		luaL_argerror(L, 3, "should have a string value");
-	const char *value = lua_tostring(L, -1);
-	size_t len = NK_CLAMP(0, strlen(value), NK_LOVE_EDIT_BUFFER_LEN - 1);
-	memcpy(edit_buffer, value, len);
-	edit_buffer[len] = '\0';
-	nk_flags event = nk_edit_string_zero_terminated(&context->nkctx, flags, edit_buffer, NK_LOVE_EDIT_BUFFER_LEN - 1, nk_filter_default);
-	lua_pushstring(L, edit_buffer);
-	lua_pushvalue(L, -1);
-	lua_setfield(L, 3, "value");
-	int changed = !lua_equal(L, -1, -2);
-	if (event & NK_EDIT_COMMITED)
-		lua_pushstring(L, "commited");
-	else if (event & NK_EDIT_ACTIVATED)
-		lua_pushstring(L, "activated");
-	else if (event & NK_EDIT_DEACTIVATED)
-		lua_pushstring(L, "deactivated");
-	else if (event & NK_EDIT_ACTIVE)
-		lua_pushstring(L, "active");
-	else if (event & NK_EDIT_INACTIVE)
-		lua_pushstring(L, "inactive");
-	else
-		lua_pushnil(L);
-	lua_pushboolean(L, changed);
-	return 2;
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_document *doc = nk_love_checkdocument(L, 1);
+	lua_pushnumber(L, doc->version);
+	return 1;
+}
+
+static int nk_love_document_gc(lua_State *L)
+{
+	struct nk_love_document *doc = lua_touserdata(L, 1);
+	free(doc->text);
+	free(doc->lines);
+	free(doc->scratch);
+	return 0;
 }
 
 int nk_love_edit_focus(lua_State *L)
@@ -3105,6 +5710,296 @@ static int nk_love_popup_set_scroll(lua_State *L)
 	return 0;
 }
 
+static struct nk_love_item_list *nk_love_checkitemlist(lua_State *L, int index)
+{
+	struct nk_love_item_list *list = nk_love_toudata(L, index, "itemlist");
+	if (list == NULL)
+		luaL_typerror(L, index, "ItemList");
+	return list;
+}
+
+static char nk_love_fold(char c)
+{
+	return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+/*
+ * Each item keeps a 32-bit summary of the characters it contains, so most
+ * items are rejected by a single mask test before the subsequence scan.
+ */
+static nk_uint nk_love_fuzzy_mask(const char *text, size_t len)
+{
+	nk_uint mask = 0;
+	size_t i;
+	for (i = 0; i < len; ++i)
+		mask |= 1u << (nk_love_fold(text[i]) & 31);
+	return mask;
+}
+
+static int nk_love_fuzzy_match(const char *item, const char *query, size_t query_len)
+{
+	size_t q = 0;
+	for (; *item != '\0' && q < query_len; ++item)
+		if (nk_love_fold(*item) == query[q])
+			q++;
+	return q == query_len;
+}
+
+/*
+ * Filter the list with its folded query. When refining, only the previous
+ * matches are tested again, since a longer query can only match fewer items.
+ */
+static void nk_love_item_list_filter(struct nk_love_item_list *list, int refine)
+{
+	nk_uint mask = nk_love_fuzzy_mask(list->query, list->query_len);
+	int i, source = refine ? list->match_count : list->count;
+	list->match_count = 0;
+	for (i = 0; i < source; ++i) {
+		int item = refine ? list->matches[i] : i;
+		if ((list->masks[item] & mask) == mask
+				&& nk_love_fuzzy_match(list->items[item], list->query, list->query_len))
+			list->matches[list->match_count++] = item;
+	}
+}
+
+static void nk_love_item_list_set(lua_State *L, struct nk_love_item_list *list, int index)
+{
+	size_t size = 0;
+	int i, count;
+	for (count = 0;; ++count) {
+		lua_rawgeti(L, index, count + 1);
+		if (lua_isnil(L, -1)) {
+			lua_pop(L, 1);
+			break;
+		}
+		if (!lua_isstring(L, -1))
+			luaL_argerror(L, index, "items must be strings");
+		size_t len;
+		lua_tolstring(L, -1, &len);
+		size += len + 1;
+		lua_pop(L, 1);
+	}
+	char *text = malloc(size > 0 ? size : 1);
+	const char **items = malloc(sizeof(char*) * (count > 0 ? count : 1));
+	nk_uint *masks = malloc(sizeof(nk_uint) * (count > 0 ? count : 1));
+	int *matches = malloc(sizeof(int) * (count > 0 ? count : 1));
+	if (text == NULL || items == NULL || masks == NULL || matches == NULL) {
+		free(text);
+		free(items);
+		free(masks);
+		free(matches);
+		nk_love_assert_alloc(L, NULL);
+	}
+	char *next = text;
+	for (i = 0; i < count; ++i) {
+		lua_rawgeti(L, index, i + 1);
+		size_t len;
+		const char *item = lua_tolstring(L, -1, &len);
+		memcpy(next, item, len + 1);
+		items[i] = next;
+		masks[i] = nk_love_fuzzy_mask(next, len);
+		next += len + 1;
+		lua_pop(L, 1);
+	}
+	free(list->text);
+	free(list->items);
+	free(list->masks);
+	free(list->matches);
+	list->text = text;
+	list->items = items;
+	list->masks = masks;
+	list->matches = matches;
+	list->count = count;
+	if (list->filtered)
+		nk_love_item_list_filter(list, 0);
+	list->version++;
+}
+
+static int nk_love_item_list_visible(const struct nk_love_item_list *list)
+{
+	return list->filtered ? list->match_count : list->count;
+}
+
+static int nk_love_item_list_index(const struct nk_love_item_list *list, int i)
+{
+	return list->filtered ? list->matches[i] : i;
+}
+
+/*
+ * Emit only the rows of an item list that are visible in the current popup.
+ * Spacers stand in for the rows above and below so the scrollbar stays right.
+ */
+static int nk_love_item_list_rows(struct nk_context *ctx, struct nk_love_item_list *list,
+	int item_height, nk_flags align)
+{
+	float spacing = ctx->style.window.spacing.y;
+	float row = item_height + spacing;
+	nk_uint offset_x, offset_y;
+	nk_popup_get_scroll(ctx, &offset_x, &offset_y);
+	struct nk_rect region = nk_window_get_content_region(ctx);
+	int count = nk_love_item_list_visible(list);
+	int first = NK_MIN(count, (int)(offset_y / row));
+	int last = NK_MIN(count, first + (int)(region.h / row) + 2);
+	int i, activated = -1;
+	if (first > 0) {
+		nk_layout_row_dynamic(ctx, first * row - spacing, 1);
+		nk_spacing(ctx, 1);
+	}
+	nk_layout_row_dynamic(ctx, item_height, 1);
+	for (i = first; i < last; ++i) {
+		int item = nk_love_item_list_index(list, i);
+		if (nk_combo_item_label(ctx, list->items[item], align))
+			activated = item;
+	}
+	if (last < count) {
+		nk_layout_row_dynamic(ctx, (count - last) * row - spacing, 1);
+		nk_spacing(ctx, 1);
+	}
+	return activated;
+}
+
+static int nk_love_combo_item_list(struct nk_context *ctx, struct nk_love_item_list *list,
+	int selected, int item_height, struct nk_vec2 size)
+{
+	if (list->count == 0)
+		return selected;
+	float spacing = ctx->style.window.spacing.y;
+	float max_height = nk_love_item_list_visible(list) * (item_height + spacing) + spacing * 2
+		+ ctx->style.window.padding.y * 2;
+	size.y = NK_MIN(size.y, max_height);
+	selected = NK_CLAMP(0, selected, list->count - 1);
+	if (nk_combo_begin_label(ctx, list->items[selected], size)) {
+		int activated = nk_love_item_list_rows(ctx, list, item_height, NK_TEXT_LEFT);
+		if (activated >= 0)
+			selected = activated;
+		nk_combo_end(ctx);
+	}
+	return selected;
+}
+
+static int nk_love_new_item_list(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_checkcontext(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	struct nk_love_item_list *list = lua_newuserdata(L, sizeof(struct nk_love_item_list));
+	nk_love_assert_alloc(L, list);
+	memset(list, 0, sizeof(struct nk_love_item_list));
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_getfield(L, -1, "itemlist");
+	lua_setmetatable(L, -3);
+	lua_pop(L, 1);
+	nk_love_item_list_set(L, list, 2);
+	list->version = 0;
+	return 1;
+}
+
+static int nk_love_item_list_set_items(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 1);
+	luaL_checktype(L, 2, LUA_TTABLE);
+	nk_love_item_list_set(L, list, 2);
+	return 0;
+}
+
+static int nk_love_item_list_get_count(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 1);
+	lua_pushinteger(L, list->count);
+	return 1;
+}
+
+static int nk_love_item_list_get_item(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 1);
+	int i = luaL_checkint(L, 2);
+	luaL_argcheck(L, i >= 1 && i <= list->count, 2, "item out of range");
+	lua_pushstring(L, list->items[i - 1]);
+	return 1;
+}
+
+static int nk_love_item_list_set_filter(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 1 && lua_gettop(L) <= 2);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 1);
+	size_t i, len = 0;
+	const char *query = NULL;
+	if (!lua_isnoneornil(L, 2))
+		query = luaL_checklstring(L, 2, &len);
+	if (len == 0) {
+		list->filtered = 0;
+		list->query_len = 0;
+		return 0;
+	}
+	int refine = list->filtered && len >= list->query_len;
+	for (i = 0; refine && i < list->query_len; ++i)
+		refine = nk_love_fold(query[i]) == list->query[i];
+	if (refine && len == list->query_len)
+		return 0;
+	char *folded = realloc(list->query, len);
+	nk_love_assert_alloc(L, folded);
+	for (i = 0; i < len; ++i)
+		folded[i] = nk_love_fold(query[i]);
+	list->query = folded;
+	list->query_len = len;
+	nk_love_item_list_filter(list, refine);
+	list->filtered = 1;
+	return 0;
+}
+
+static int nk_love_item_list_get_filter(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 1);
+	if (list->filtered)
+		lua_pushlstring(L, list->query, list->query_len);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
+static int nk_love_item_list_get_match_count(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 1);
+	lua_pushinteger(L, nk_love_item_list_visible(list));
+	return 1;
+}
+
+static int nk_love_item_list_get_match(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 1);
+	int i = luaL_checkint(L, 2);
+	luaL_argcheck(L, i >= 1 && i <= nk_love_item_list_visible(list), 2, "match out of range");
+	int item = nk_love_item_list_index(list, i - 1);
+	lua_pushinteger(L, item + 1);
+	lua_pushstring(L, list->items[item]);
+	return 2;
+}
+
+static int nk_love_item_list_get_version(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 1);
+	lua_pushnumber(L, list->version);
+	return 1;
+}
+
+static int nk_love_item_list_gc(lua_State *L)
+{
+	struct nk_love_item_list *list = lua_touserdata(L, 1);
+	free(list->text);
+	free(list->items);
+	free(list->masks);
+	free(list->matches);
+	free(list->query);
+	return 0;
+}
+
 static int nk_love_combobox(lua_State *L)
 {
 	int argc = lua_gettop(L);
@@ -3130,10 +6025,16 @@ static int nk_love_combobox(lua_State *L)
 		}
 		return 0;
 	}
-	if (!lua_istable(L, 3))
-		luaL_typerror(L, 3, "table");
-	int i;
-	for (i = 0; i < NK_LOVE_COMBOBOX_MAX_ITEMS && lua_checkstack(L, 4); ++i) {
+	struct nk_love_item_list *list = nk_love_toudata(L, 3, "itemlist");
+	if (list == NULL && !lua_istable(L, 3))
+		luaL_typerror(L, 3, "table or ItemList");
+	int i, count = list == NULL ? lua_objlen(L, 3) : 0;
+	const char **combobox_items = NULL;
+	if (count > 0) {
+		nk_love_assert(L, lua_checkstack(L, count + 4), "%s: failed to allocate stack space");
+		combobox_items = nk_love_arena_alloc(L, sizeof(char*) * count);
+	}
+	for (i = 0; i < count; ++i) {
 		lua_rawgeti(L, 3, i + 1);
 		if (lua_isstring(L, -1))
 			combobox_items[i] = lua_tostring(L, -1);
@@ -3153,7 +6054,10 @@ static int nk_love_combobox(lua_State *L)
 		size.y = luaL_checknumber(L, 6);
 	if (lua_isnumber(L, 2)) {
 		int value = luaL_checkinteger(L, 2) - 1;
-		value = nk_combo(&context->nkctx, combobox_items, i, value, item_height, size);
+		if (list != NULL)
+			value = nk_love_combo_item_list(&context->nkctx, list, value, item_height, size);
+		else
+			value = nk_combo(&context->nkctx, combobox_items, i, value, item_height, size);
 		lua_pushnumber(L, value + 1);
 	} else if (lua_istable(L, 2)) {
 		lua_getfield(L, 2, "value");
@@ -3161,7 +6065,10 @@ static int nk_love_combobox(lua_State *L)
 			luaL_argerror(L, 2, "should have a number value");
 		int value = luaL_checkinteger(L, -1) - 1;
 		int old = value;
-		nk_combobox(&context->nkctx, combobox_items, i, &value, item_height, size);
+		if (list != NULL)
+			value = nk_love_combo_item_list(&context->nkctx, list, value, item_height, size);
+		else
+			nk_combobox(&context->nkctx, combobox_items, i, &value, item_height, size);
 		int changed = value != old;
 		if (changed) {
 			lua_pushnumber(L, value + 1);
@@ -3188,13 +6095,10 @@ static int nk_love_combobox_begin(lua_State *L)
 	struct nk_image image;
 	int use_image = 0;
 	if (argc >= 3 && !lua_isnil(L, 3)) {
-		if (lua_isstring(L, 3)) {
-			if (nk_love_is_color(L, 3)) {
-				color = nk_love_checkcolor(L, 3);
-				use_color = 1;
-			} else {
-				symbol = nk_love_checksymbol(L, 3);
-			}
+		if (nk_love_tocolor(L, 3, &color)) {
+			use_color = 1;
+		} else if (lua_isstring(L, 3)) {
+			symbol = nk_love_checksymbol(L, 3);
 		} else {
 			nk_love_checkImage(L, 3, &image);
 			use_image = 1;
@@ -3261,6 +6165,27 @@ static int nk_love_combobox_item(lua_State *L)
 	return 1;
 }
 
+static int nk_love_combobox_items(lua_State *L)
+{
+	int argc = lua_gettop(L);
+	nk_love_assert_argc(L, argc >= 2 && argc <= 4);
+	nk_love_assert_context(L, 1);
+	struct nk_love_item_list *list = nk_love_checkitemlist(L, 2);
+	struct nk_context *ctx = &context->nkctx;
+	int item_height = ctx->style.font->height + ctx->style.contextual_button.padding.y * 2;
+	if (argc >= 3 && !lua_isnil(L, 3))
+		item_height = luaL_checkint(L, 3);
+	nk_flags align = NK_TEXT_LEFT;
+	if (argc >= 4 && !lua_isnil(L, 4))
+		align = nk_love_checkalign(L, 4);
+	int activated = nk_love_item_list_rows(ctx, list, item_height, align);
+	if (activated >= 0)
+		lua_pushinteger(L, activated + 1);
+	else
+		lua_pushnil(L);
+	return 1;
+}
+
 static int nk_love_combobox_close(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
@@ -3570,16 +6495,16 @@ static int nk_love_style_default(lua_State *L)
 	nk_love_assert_argc(L, lua_gettop(L) == 1);
 	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
 	nk_style_default(&ctx->nkctx);
+	ctx->style_generation++;
 	return 0;
 }
 
 #define NK_LOVE_LOAD_COLOR(type) \
 	lua_getfield(L, -1, (type)); \
-	if (!nk_love_is_color(L, -1)) { \
+	if (!nk_love_tocolor(L, -1, &colors[index++])) { \
 		const char *msg = lua_pushfstring(L, "%%s: table missing color value for '%s'", type); \
 		nk_love_assert(L, 0, msg); \
 	} \
-	colors[index++] = nk_love_checkcolor(L, -1); \
 	lua_pop(L, 1)
 
 static int nk_love_style_load_colors(lua_State *L)
@@ -3619,6 +6544,7 @@ static int nk_love_style_load_colors(lua_State *L)
 	NK_LOVE_LOAD_COLOR("scrollbar cursor active");
 	NK_LOVE_LOAD_COLOR("tab header");
 	nk_style_from_table(&ctx->nkctx, colors);
+	ctx->style_generation++;
 	return 0;
 }
 
@@ -3626,476 +6552,545 @@ static int nk_love_style_set_font(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 2);
 	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	nk_love_checkFont(L, 2, &ctx->fonts[ctx->font_count]);
-	nk_style_set_font(&ctx->nkctx, &ctx->fonts[ctx->font_count++].font);
+	struct nk_love_context *current = context;
+	context = ctx;
+	struct nk_love_font *font = nk_love_checkFont(L, 2);
+	context = current;
+	nk_style_set_font(&ctx->nkctx, &font->font);
 	return 0;
 }
 
-static int nk_love_style_push_color(lua_State *L, struct nk_color *field)
+static const size_t nk_love_style_sizes[] = {
+	sizeof(struct nk_color),
+	sizeof(struct nk_vec2),
+	sizeof(struct nk_style_item),
+	sizeof(nk_flags),
+	sizeof(float),
+	sizeof(const struct nk_user_font *)
+};
+
+static struct nk_love_style *nk_love_checkstyle(lua_State *L, int index)
 {
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	if (!nk_love_is_color(L, -1)) {
-		const char *msg = lua_pushfstring(L, "%%s: bad color string '%s'", lua_tostring(L, -1));
-		nk_love_assert(L, 0, msg);
+	struct nk_love_style *style = nk_love_toudata(L, index, "style");
+	if (style == NULL)
+		luaL_typerror(L, index, "Style");
+	return style;
+}
+
+static void nk_love_style_add(lua_State *L, enum nk_love_style_kind kind, void *field,
+	const union nk_love_style_value *value, int ref)
+{
+	struct nk_love_context *ctx = lua_touserdata(L, 1);
+	struct nk_love_style *style = lua_touserdata(L, 2);
+	if (style->count == style->capacity) {
+		int capacity = NK_MAX(style->capacity * 2, 16);
+		struct nk_love_style_entry *entries = realloc(style->entries,
+			sizeof(struct nk_love_style_entry) * capacity);
+		nk_love_assert_alloc(L, entries);
+		style->entries = entries;
+		style->capacity = capacity;
 	}
-	struct nk_color color = nk_love_checkcolor(L, -1);
-	int success = nk_style_push_color(&ctx->nkctx, field, color);
-	if (success) {
-		lua_pushstring(L, "color");
-		size_t stack_size = lua_objlen(L, 2);
-		lua_rawseti(L, 2, stack_size + 1);
+	struct nk_love_style_entry *entry = &style->entries[style->count++];
+	entry->kind = kind;
+	entry->offset = (char *) field - (char *) &ctx->nkctx.style;
+	entry->ref = ref;
+	entry->value = *value;
+}
+
+static int nk_love_style_ref(lua_State *L)
+{
+	lua_getfenv(L, 2);
+	int ref = lua_objlen(L, -1) + 1;
+	lua_pushvalue(L, -2);
+	lua_rawseti(L, -2, ref);
+	lua_pop(L, 1);
+	return ref;
+}
+
+static void nk_love_style_compile_color(lua_State *L, struct nk_color *field)
+{
+	union nk_love_style_value value;
+	if (!nk_love_tocolor(L, -1, &value.color)) {
+		const char *msg = lua_pushfstring(L, "%%s: bad color '%s'",
+				lua_isstring(L, -1) ? lua_tostring(L, -1) : luaL_typename(L, -1));
+		nk_love_assert(L, 0, msg);
 	}
-	return success;
+	nk_love_style_add(L, NK_LOVE_STYLE_COLOR, field, &value, 0);
 }
 
-static int nk_love_style_push_vec2(lua_State *L, struct nk_vec2 *field)
+static void nk_love_style_compile_vec2(lua_State *L, struct nk_vec2 *field)
 {
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
 	static const char *msg = "%s: vec2 fields must have x and y components";
 	nk_love_assert(L, lua_istable(L, -1), msg);
 	lua_getfield(L, -1, "x");
 	nk_love_assert(L, lua_isnumber(L, -1), msg);
 	lua_getfield(L, -2, "y");
 	nk_love_assert(L, lua_isnumber(L, -1), msg);
-	struct nk_vec2 vec2;
-	vec2.x = lua_tonumber(L, -2);
-	vec2.y = lua_tonumber(L, -1);
+	union nk_love_style_value value;
+	value.vec2.x = lua_tonumber(L, -2);
+	value.vec2.y = lua_tonumber(L, -1);
 	lua_pop(L, 2);
-	int success = nk_style_push_vec2(&ctx->nkctx, field, vec2);
-	if (success) {
-		lua_pushstring(L, "vec2");
-		size_t stack_size = lua_objlen(L, 2);
-		lua_rawseti(L, 2, stack_size + 1);
-	}
-	return success;
+	nk_love_style_add(L, NK_LOVE_STYLE_VEC2, field, &value, 0);
 }
 
-static int nk_love_style_push_item(lua_State *L, struct nk_style_item *field)
+static void nk_love_style_compile_item(lua_State *L, struct nk_style_item *field)
 {
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	struct nk_style_item item;
-	if (lua_isstring(L, -1)) {
-		if (!nk_love_is_color(L, -1)) {
-			const char *msg = lua_pushfstring(L, "%%s: bad color string '%s'", lua_tostring(L, -1));
-			nk_love_assert(L, 0, msg);
-		}
-		item.type = NK_STYLE_ITEM_COLOR;
-		item.data.color = nk_love_checkcolor(L, -1);
+	union nk_love_style_value value;
+	int ref = 0;
+	if (nk_love_tocolor(L, -1, &value.item.data.color)) {
+		value.item.type = NK_STYLE_ITEM_COLOR;
+	} else if (lua_isstring(L, -1)) {
+		const char *msg = lua_pushfstring(L, "%%s: bad color string '%s'", lua_tostring(L, -1));
+		nk_love_assert(L, 0, msg);
 	} else {
-		item.type = NK_STYLE_ITEM_IMAGE;
-		nk_love_checkImage(L, -1, &item.data.image);
+		value.item.type = NK_STYLE_ITEM_IMAGE;
+		nk_love_checkImage(L, -1, &value.item.data.image);
+		ref = nk_love_style_ref(L);
 	}
-	int success = nk_style_push_style_item(&ctx->nkctx, field, item);
-	if (success) {
-		lua_pushstring(L, "item");
-		size_t stack_size = lua_objlen(L, 2);
-		lua_rawseti(L, 2, stack_size + 1);
-	}
-	return success;
+	nk_love_style_add(L, NK_LOVE_STYLE_ITEM, field, &value, ref);
 }
 
-static int nk_love_style_push_align(lua_State *L, nk_flags *field)
+static void nk_love_style_compile_align(lua_State *L, nk_flags *field)
 {
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	nk_flags align = nk_love_checkalign(L, -1);
-	int success = nk_style_push_flags(&ctx->nkctx, field, align);
-	if (success) {
-		lua_pushstring(L, "flags");
-		size_t stack_size = lua_objlen(L, 2);
-		lua_rawseti(L, 2, stack_size + 1);
-	}
-	return success;
+	union nk_love_style_value value;
+	value.flags = nk_love_checkalign(L, -1);
+	nk_love_style_add(L, NK_LOVE_STYLE_FLAGS, field, &value, 0);
 }
 
-static int nk_love_style_push_float(lua_State *L, float *field)
+static void nk_love_style_compile_float(lua_State *L, float *field)
 {
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	float f = luaL_checknumber(L, -1);
-	int success = nk_style_push_float(&ctx->nkctx, field, f);
-	if (success) {
-		lua_pushstring(L, "float");
-		size_t stack_size = lua_objlen(L, 2);
-		lua_rawseti(L, 2, stack_size + 1);
-	}
-	return success;
+	union nk_love_style_value value;
+	value.f = luaL_checknumber(L, -1);
+	nk_love_style_add(L, NK_LOVE_STYLE_FLOAT, field, &value, 0);
 }
 
-static int nk_love_style_push_font(lua_State *L, const struct nk_user_font **field)
+static void nk_love_style_compile_font(lua_State *L, const struct nk_user_font **field)
 {
-	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
-	nk_love_checkFont(L, -1, &context->fonts[context->font_count]);
-	int success = nk_style_push_font(&ctx->nkctx, &context->fonts[context->font_count++].font);
-	if (success) {
-		lua_pushstring(L, "font");
-		size_t stack_size = lua_objlen(L, 2);
-		lua_rawseti(L, 2, stack_size + 1);
-	}
-	return success;
+	union nk_love_style_value value;
+	value.font = &nk_love_checkFont(L, -1)->font;
+	nk_love_style_add(L, NK_LOVE_STYLE_FONT, field, &value, nk_love_style_ref(L));
 }
 
-#define NK_LOVE_STYLE_PUSH(name, type, field) \
+#define NK_LOVE_STYLE_COMPILE(name, type, field) \
 	nk_love_assert(L, lua_istable(L, -1), "%s: " name " field must be a table"); \
 	lua_getfield(L, -1, name); \
 	if (!lua_isnil(L, -1)) \
-		nk_love_style_push_##type(L, field); \
+		nk_love_style_compile_##type(L, field); \
 	lua_pop(L, 1);
 
-static void nk_love_style_push_text(lua_State *L, struct nk_style_text *style)
+static void nk_love_style_compile_text(lua_State *L, struct nk_style_text *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: text style must be a table");
-	NK_LOVE_STYLE_PUSH("color", color, &style->color);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("color", color, &style->color);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
 }
 
-static void nk_love_style_push_button(lua_State *L, struct nk_style_button *style)
+static void nk_love_style_compile_button(lua_State *L, struct nk_style_button *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: button style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("text background", color, &style->text_background);
-	NK_LOVE_STYLE_PUSH("text normal", color, &style->text_normal);
-	NK_LOVE_STYLE_PUSH("text hover", color, &style->text_hover);
-	NK_LOVE_STYLE_PUSH("text active", color, &style->text_active);
-	NK_LOVE_STYLE_PUSH("text alignment", align, &style->text_alignment);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("image padding", vec2, &style->image_padding);
-	NK_LOVE_STYLE_PUSH("touch padding", vec2, &style->touch_padding);
-}
-
-static void nk_love_style_push_scrollbar(lua_State *L, struct nk_style_scrollbar *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("text background", color, &style->text_background);
+	NK_LOVE_STYLE_COMPILE("text normal", color, &style->text_normal);
+	NK_LOVE_STYLE_COMPILE("text hover", color, &style->text_hover);
+	NK_LOVE_STYLE_COMPILE("text active", color, &style->text_active);
+	NK_LOVE_STYLE_COMPILE("text alignment", align, &style->text_alignment);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("image padding", vec2, &style->image_padding);
+	NK_LOVE_STYLE_COMPILE("touch padding", vec2, &style->touch_padding);
+}
+
+static void nk_love_style_compile_scrollbar(lua_State *L, struct nk_style_scrollbar *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: scrollbar style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("cursor normal", item, &style->cursor_normal);
-	NK_LOVE_STYLE_PUSH("cursor hover", item, &style->cursor_hover);
-	NK_LOVE_STYLE_PUSH("cursor active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("cursor border color", color, &style->cursor_border_color);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("border cursor", float, &style->border_cursor);
-	NK_LOVE_STYLE_PUSH("rounding cursor", float, &style->rounding_cursor);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-}
-
-static void nk_love_style_push_edit(lua_State *L, struct nk_style_edit *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("cursor normal", item, &style->cursor_normal);
+	NK_LOVE_STYLE_COMPILE("cursor hover", item, &style->cursor_hover);
+	NK_LOVE_STYLE_COMPILE("cursor active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("cursor border color", color, &style->cursor_border_color);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("border cursor", float, &style->border_cursor);
+	NK_LOVE_STYLE_COMPILE("rounding cursor", float, &style->rounding_cursor);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+}
+
+static void nk_love_style_compile_edit(lua_State *L, struct nk_style_edit *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: edit style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("scrollbar", scrollbar, &style->scrollbar);
-	NK_LOVE_STYLE_PUSH("cursor normal", color, &style->cursor_normal);
-	NK_LOVE_STYLE_PUSH("cursor hover", color, &style->cursor_hover);
-	NK_LOVE_STYLE_PUSH("cursor text normal", color, &style->cursor_text_normal);
-	NK_LOVE_STYLE_PUSH("cursor text hover", color, &style->cursor_text_hover);
-	NK_LOVE_STYLE_PUSH("text normal", color, &style->text_normal);
-	NK_LOVE_STYLE_PUSH("text hover", color, &style->text_hover);
-	NK_LOVE_STYLE_PUSH("text active", color, &style->text_active);
-	NK_LOVE_STYLE_PUSH("selected normal", color, &style->selected_normal);
-	NK_LOVE_STYLE_PUSH("selected hover", color, &style->selected_hover);
-	NK_LOVE_STYLE_PUSH("selected text normal", color, &style->text_normal);
-	NK_LOVE_STYLE_PUSH("selected text hover", color, &style->selected_text_hover);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("cursor size", float, &style->cursor_size);
-	NK_LOVE_STYLE_PUSH("scrollbar size", vec2, &style->scrollbar_size);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("row padding", float, &style->row_padding);
-}
-
-static void nk_love_style_push_toggle(lua_State *L, struct nk_style_toggle *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("scrollbar", scrollbar, &style->scrollbar);
+	NK_LOVE_STYLE_COMPILE("cursor normal", color, &style->cursor_normal);
+	NK_LOVE_STYLE_COMPILE("cursor hover", color, &style->cursor_hover);
+	NK_LOVE_STYLE_COMPILE("cursor text normal", color, &style->cursor_text_normal);
+	NK_LOVE_STYLE_COMPILE("cursor text hover", color, &style->cursor_text_hover);
+	NK_LOVE_STYLE_COMPILE("text normal", color, &style->text_normal);
+	NK_LOVE_STYLE_COMPILE("text hover", color, &style->text_hover);
+	NK_LOVE_STYLE_COMPILE("text active", color, &style->text_active);
+	NK_LOVE_STYLE_COMPILE("selected normal", color, &style->selected_normal);
+	NK_LOVE_STYLE_COMPILE("selected hover", color, &style->selected_hover);
+	NK_LOVE_STYLE_COMPILE("selected text normal", color, &style->text_normal);
+	NK_LOVE_STYLE_COMPILE("selected text hover", color, &style->selected_text_hover);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("cursor size", float, &style->cursor_size);
+	NK_LOVE_STYLE_COMPILE("scrollbar size", vec2, &style->scrollbar_size);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("row padding", float, &style->row_padding);
+}
+
+static void nk_love_style_compile_toggle(lua_State *L, struct nk_style_toggle *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: toggle style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("cursor normal", item, &style->cursor_normal);
-	NK_LOVE_STYLE_PUSH("cursor hover", item, &style->cursor_hover);
-	NK_LOVE_STYLE_PUSH("text normal", color, &style->text_normal);
-	NK_LOVE_STYLE_PUSH("text hover", color, &style->text_hover);
-	NK_LOVE_STYLE_PUSH("text active", color, &style->text_active);
-	NK_LOVE_STYLE_PUSH("text background", color, &style->text_background);
-	NK_LOVE_STYLE_PUSH("text alignment", align, &style->text_alignment);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("touch padding", vec2, &style->touch_padding);
-	NK_LOVE_STYLE_PUSH("spacing", float, &style->spacing);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-}
-
-static void nk_love_style_push_selectable(lua_State *L, struct nk_style_selectable *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("cursor normal", item, &style->cursor_normal);
+	NK_LOVE_STYLE_COMPILE("cursor hover", item, &style->cursor_hover);
+	NK_LOVE_STYLE_COMPILE("text normal", color, &style->text_normal);
+	NK_LOVE_STYLE_COMPILE("text hover", color, &style->text_hover);
+	NK_LOVE_STYLE_COMPILE("text active", color, &style->text_active);
+	NK_LOVE_STYLE_COMPILE("text background", color, &style->text_background);
+	NK_LOVE_STYLE_COMPILE("text alignment", align, &style->text_alignment);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("touch padding", vec2, &style->touch_padding);
+	NK_LOVE_STYLE_COMPILE("spacing", float, &style->spacing);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+}
+
+static void nk_love_style_compile_selectable(lua_State *L, struct nk_style_selectable *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: selectable style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("pressed", item, &style->pressed);
-	NK_LOVE_STYLE_PUSH("normal active", item, &style->normal_active);
-	NK_LOVE_STYLE_PUSH("hover active", item, &style->hover_active);
-	NK_LOVE_STYLE_PUSH("pressed active", item, &style->pressed_active);
-	NK_LOVE_STYLE_PUSH("text normal", color, &style->text_normal);
-	NK_LOVE_STYLE_PUSH("text hover", color, &style->text_hover);
-	NK_LOVE_STYLE_PUSH("text pressed", color, &style->text_pressed);
-	NK_LOVE_STYLE_PUSH("text normal active", color, &style->text_normal_active);
-	NK_LOVE_STYLE_PUSH("text hover active", color, &style->text_hover_active);
-	NK_LOVE_STYLE_PUSH("text pressed active", color, &style->text_pressed_active);
-	NK_LOVE_STYLE_PUSH("text background", color, &style->text_background);
-	NK_LOVE_STYLE_PUSH("text alignment", align, &style->text_alignment);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("touch padding", vec2, &style->touch_padding);
-	NK_LOVE_STYLE_PUSH("image padding", vec2, &style->image_padding);
-}
-
-static void nk_love_style_push_slider(lua_State *L, struct nk_style_slider *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("pressed", item, &style->pressed);
+	NK_LOVE_STYLE_COMPILE("normal active", item, &style->normal_active);
+	NK_LOVE_STYLE_COMPILE("hover active", item, &style->hover_active);
+	NK_LOVE_STYLE_COMPILE("pressed active", item, &style->pressed_active);
+	NK_LOVE_STYLE_COMPILE("text normal", color, &style->text_normal);
+	NK_LOVE_STYLE_COMPILE("text hover", color, &style->text_hover);
+	NK_LOVE_STYLE_COMPILE("text pressed", color, &style->text_pressed);
+	NK_LOVE_STYLE_COMPILE("text normal active", color, &style->text_normal_active);
+	NK_LOVE_STYLE_COMPILE("text hover active", color, &style->text_hover_active);
+	NK_LOVE_STYLE_COMPILE("text pressed active", color, &style->text_pressed_active);
+	NK_LOVE_STYLE_COMPILE("text background", color, &style->text_background);
+	NK_LOVE_STYLE_COMPILE("text alignment", align, &style->text_alignment);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("touch padding", vec2, &style->touch_padding);
+	NK_LOVE_STYLE_COMPILE("image padding", vec2, &style->image_padding);
+}
+
+static void nk_love_style_compile_slider(lua_State *L, struct nk_style_slider *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: slider style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("bar normal", color, &style->bar_normal);
-	NK_LOVE_STYLE_PUSH("bar active", color, &style->bar_active);
-	NK_LOVE_STYLE_PUSH("bar filled", color, &style->bar_filled);
-	NK_LOVE_STYLE_PUSH("cursor normal", item, &style->cursor_normal);
-	NK_LOVE_STYLE_PUSH("cursor hover", item, &style->cursor_hover);
-	NK_LOVE_STYLE_PUSH("cursor active", item, &style->cursor_active);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("bar height", float, &style->bar_height);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("spacing", vec2, &style->spacing);
-	NK_LOVE_STYLE_PUSH("cursor size", vec2, &style->cursor_size);
-}
-
-static void nk_love_style_push_progress(lua_State *L, struct nk_style_progress *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("bar normal", color, &style->bar_normal);
+	NK_LOVE_STYLE_COMPILE("bar active", color, &style->bar_active);
+	NK_LOVE_STYLE_COMPILE("bar filled", color, &style->bar_filled);
+	NK_LOVE_STYLE_COMPILE("cursor normal", item, &style->cursor_normal);
+	NK_LOVE_STYLE_COMPILE("cursor hover", item, &style->cursor_hover);
+	NK_LOVE_STYLE_COMPILE("cursor active", item, &style->cursor_active);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("bar height", float, &style->bar_height);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("spacing", vec2, &style->spacing);
+	NK_LOVE_STYLE_COMPILE("cursor size", vec2, &style->cursor_size);
+}
+
+static void nk_love_style_compile_progress(lua_State *L, struct nk_style_progress *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: progress style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("cursor normal", item, &style->cursor_normal);
-	NK_LOVE_STYLE_PUSH("cursor hover", item, &style->cursor_hover);
-	NK_LOVE_STYLE_PUSH("cursor active", item, &style->cursor_active);
-	NK_LOVE_STYLE_PUSH("cursor border color", color, &style->cursor_border_color);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("cursor border", float, &style->cursor_border);
-	NK_LOVE_STYLE_PUSH("cursor rounding", float, &style->cursor_rounding);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-}
-
-static void nk_love_style_push_property(lua_State *L, struct nk_style_property *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("cursor normal", item, &style->cursor_normal);
+	NK_LOVE_STYLE_COMPILE("cursor hover", item, &style->cursor_hover);
+	NK_LOVE_STYLE_COMPILE("cursor active", item, &style->cursor_active);
+	NK_LOVE_STYLE_COMPILE("cursor border color", color, &style->cursor_border_color);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("cursor border", float, &style->cursor_border);
+	NK_LOVE_STYLE_COMPILE("cursor rounding", float, &style->cursor_rounding);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+}
+
+static void nk_love_style_compile_property(lua_State *L, struct nk_style_property *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: property style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("label normal", color, &style->label_normal);
-	NK_LOVE_STYLE_PUSH("label hover", color, &style->label_hover);
-	NK_LOVE_STYLE_PUSH("label active", color, &style->label_active);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("edit", edit, &style->edit);
-	NK_LOVE_STYLE_PUSH("inc button", button, &style->inc_button);
-	NK_LOVE_STYLE_PUSH("dec button", button, &style->dec_button);
-}
-
-static void nk_love_style_push_chart(lua_State *L, struct nk_style_chart *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("label normal", color, &style->label_normal);
+	NK_LOVE_STYLE_COMPILE("label hover", color, &style->label_hover);
+	NK_LOVE_STYLE_COMPILE("label active", color, &style->label_active);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("edit", edit, &style->edit);
+	NK_LOVE_STYLE_COMPILE("inc button", button, &style->inc_button);
+	NK_LOVE_STYLE_COMPILE("dec button", button, &style->dec_button);
+}
+
+static void nk_love_style_compile_chart(lua_State *L, struct nk_style_chart *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: chart style must be a table");
-	NK_LOVE_STYLE_PUSH("background", item, &style->background);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("selected color", color, &style->selected_color);
-	NK_LOVE_STYLE_PUSH("color", color, &style->color);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("background", item, &style->background);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("selected color", color, &style->selected_color);
+	NK_LOVE_STYLE_COMPILE("color", color, &style->color);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
 }
 
-static void nk_love_style_push_tab(lua_State *L, struct nk_style_tab *style)
+static void nk_love_style_compile_tab(lua_State *L, struct nk_style_tab *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: tab style must be a table");
-	NK_LOVE_STYLE_PUSH("background", item, &style->background);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("text", color, &style->text);
-	NK_LOVE_STYLE_PUSH("tab maximize button", button, &style->tab_maximize_button);
-	NK_LOVE_STYLE_PUSH("tab minimize button", button, &style->tab_minimize_button);
-	NK_LOVE_STYLE_PUSH("node maximize button", button, &style->node_maximize_button);
-	NK_LOVE_STYLE_PUSH("node minimize button", button, &style->node_minimize_button);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("indent", float, &style->indent);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("spacing", vec2, &style->spacing);
-}
-
-static void nk_love_style_push_combo(lua_State *L, struct nk_style_combo *style)
+	NK_LOVE_STYLE_COMPILE("background", item, &style->background);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("text", color, &style->text);
+	NK_LOVE_STYLE_COMPILE("tab maximize button", button, &style->tab_maximize_button);
+	NK_LOVE_STYLE_COMPILE("tab minimize button", button, &style->tab_minimize_button);
+	NK_LOVE_STYLE_COMPILE("node maximize button", button, &style->node_maximize_button);
+	NK_LOVE_STYLE_COMPILE("node minimize button", button, &style->node_minimize_button);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("indent", float, &style->indent);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("spacing", vec2, &style->spacing);
+}
+
+static void nk_love_style_compile_combo(lua_State *L, struct nk_style_combo *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: combo style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("label normal", color, &style->label_normal);
-	NK_LOVE_STYLE_PUSH("label hover", color, &style->label_hover);
-	NK_LOVE_STYLE_PUSH("label active", color, &style->label_active);
-	NK_LOVE_STYLE_PUSH("symbol normal", color, &style->symbol_normal);
-	NK_LOVE_STYLE_PUSH("symbol hover", color, &style->symbol_hover);
-	NK_LOVE_STYLE_PUSH("symbol active", color, &style->symbol_active);
-	NK_LOVE_STYLE_PUSH("button", button, &style->button);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("content padding", vec2, &style->content_padding);
-	NK_LOVE_STYLE_PUSH("button padding", vec2, &style->button_padding);
-	NK_LOVE_STYLE_PUSH("spacing", vec2, &style->spacing);
-}
-
-static void nk_love_style_push_window_header(lua_State *L, struct nk_style_window_header *style)
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("label normal", color, &style->label_normal);
+	NK_LOVE_STYLE_COMPILE("label hover", color, &style->label_hover);
+	NK_LOVE_STYLE_COMPILE("label active", color, &style->label_active);
+	NK_LOVE_STYLE_COMPILE("symbol normal", color, &style->symbol_normal);
+	NK_LOVE_STYLE_COMPILE("symbol hover", color, &style->symbol_hover);
+	NK_LOVE_STYLE_COMPILE("symbol active", color, &style->symbol_active);
+	NK_LOVE_STYLE_COMPILE("button", button, &style->button);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("content padding", vec2, &style->content_padding);
+	NK_LOVE_STYLE_COMPILE("button padding", vec2, &style->button_padding);
+	NK_LOVE_STYLE_COMPILE("spacing", vec2, &style->spacing);
+}
+
+static void nk_love_style_compile_window_header(lua_State *L, struct nk_style_window_header *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: window header style must be a table");
-	NK_LOVE_STYLE_PUSH("normal", item, &style->normal);
-	NK_LOVE_STYLE_PUSH("hover", item, &style->hover);
-	NK_LOVE_STYLE_PUSH("active", item, &style->active);
-	NK_LOVE_STYLE_PUSH("close button", button, &style->close_button);
-	NK_LOVE_STYLE_PUSH("minimize button", button, &style->minimize_button);
-	NK_LOVE_STYLE_PUSH("label normal", color, &style->label_normal);
-	NK_LOVE_STYLE_PUSH("label hover", color, &style->label_hover);
-	NK_LOVE_STYLE_PUSH("label active", color, &style->label_active);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("label padding", vec2, &style->label_padding);
-	NK_LOVE_STYLE_PUSH("spacing", vec2, &style->spacing);
+	NK_LOVE_STYLE_COMPILE("normal", item, &style->normal);
+	NK_LOVE_STYLE_COMPILE("hover", item, &style->hover);
+	NK_LOVE_STYLE_COMPILE("active", item, &style->active);
+	NK_LOVE_STYLE_COMPILE("close button", button, &style->close_button);
+	NK_LOVE_STYLE_COMPILE("minimize button", button, &style->minimize_button);
+	NK_LOVE_STYLE_COMPILE("label normal", color, &style->label_normal);
+	NK_LOVE_STYLE_COMPILE("label hover", color, &style->label_hover);
+	NK_LOVE_STYLE_COMPILE("label active", color, &style->label_active);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("label padding", vec2, &style->label_padding);
+	NK_LOVE_STYLE_COMPILE("spacing", vec2, &style->spacing);
 }
 
-static void nk_love_style_push_window(lua_State *L, struct nk_style_window *style)
+static void nk_love_style_compile_window(lua_State *L, struct nk_style_window *style)
 {
 	nk_love_assert(L, lua_istable(L, -1), "%s: window style must be a table");
-	NK_LOVE_STYLE_PUSH("header", window_header, &style->header);
-	NK_LOVE_STYLE_PUSH("fixed background", item, &style->fixed_background);
-	NK_LOVE_STYLE_PUSH("background", color, &style->background);
-	NK_LOVE_STYLE_PUSH("border color", color, &style->border_color);
-	NK_LOVE_STYLE_PUSH("popup border color", color, &style->popup_border_color);
-	NK_LOVE_STYLE_PUSH("combo border color", color, &style->combo_border_color);
-	NK_LOVE_STYLE_PUSH("contextual border color", color, &style->contextual_border_color);
-	NK_LOVE_STYLE_PUSH("menu border color", color, &style->menu_border_color);
-	NK_LOVE_STYLE_PUSH("group border color", color, &style->group_border_color);
-	NK_LOVE_STYLE_PUSH("tooltip border color", color, &style->tooltip_border_color);
-	NK_LOVE_STYLE_PUSH("scaler", item, &style->scaler);
-	NK_LOVE_STYLE_PUSH("border", float, &style->border);
-	NK_LOVE_STYLE_PUSH("combo border", float, &style->combo_border);
-	NK_LOVE_STYLE_PUSH("contextual border", float, &style->contextual_border);
-	NK_LOVE_STYLE_PUSH("menu border", float, &style->menu_border);
-	NK_LOVE_STYLE_PUSH("group border", float, &style->group_border);
-	NK_LOVE_STYLE_PUSH("tooltip border", float, &style->tooltip_border);
-	NK_LOVE_STYLE_PUSH("popup border", float, &style->popup_border);
-	NK_LOVE_STYLE_PUSH("rounding", float, &style->rounding);
-	NK_LOVE_STYLE_PUSH("spacing", vec2, &style->spacing);
-	NK_LOVE_STYLE_PUSH("scrollbar size", vec2, &style->scrollbar_size);
-	NK_LOVE_STYLE_PUSH("min size", vec2, &style->min_size);
-	NK_LOVE_STYLE_PUSH("padding", vec2, &style->padding);
-	NK_LOVE_STYLE_PUSH("group padding", vec2, &style->group_padding);
-	NK_LOVE_STYLE_PUSH("popup padding", vec2, &style->popup_padding);
-	NK_LOVE_STYLE_PUSH("combo padding", vec2, &style->combo_padding);
-	NK_LOVE_STYLE_PUSH("contextual padding", vec2, &style->contextual_padding);
-	NK_LOVE_STYLE_PUSH("menu padding", vec2, &style->menu_padding);
-	NK_LOVE_STYLE_PUSH("tooltip padding", vec2, &style->tooltip_padding);
+	NK_LOVE_STYLE_COMPILE("header", window_header, &style->header);
+	NK_LOVE_STYLE_COMPILE("fixed background", item, &style->fixed_background);
+	NK_LOVE_STYLE_COMPILE("background", color, &style->background);
+	NK_LOVE_STYLE_COMPILE("border color", color, &style->border_color);
+	NK_LOVE_STYLE_COMPILE("popup border color", color, &style->popup_border_color);
+	NK_LOVE_STYLE_COMPILE("combo border color", color, &style->combo_border_color);
+	NK_LOVE_STYLE_COMPILE("contextual border color", color, &style->contextual_border_color);
+	NK_LOVE_STYLE_COMPILE("menu border color", color, &style->menu_border_color);
+	NK_LOVE_STYLE_COMPILE("group border color", color, &style->group_border_color);
+	NK_LOVE_STYLE_COMPILE("tooltip border color", color, &style->tooltip_border_color);
+	NK_LOVE_STYLE_COMPILE("scaler", item, &style->scaler);
+	NK_LOVE_STYLE_COMPILE("border", float, &style->border);
+	NK_LOVE_STYLE_COMPILE("combo border", float, &style->combo_border);
+	NK_LOVE_STYLE_COMPILE("contextual border", float, &style->contextual_border);
+	NK_LOVE_STYLE_COMPILE("menu border", float, &style->menu_border);
+	NK_LOVE_STYLE_COMPILE("group border", float, &style->group_border);
+	NK_LOVE_STYLE_COMPILE("tooltip border", float, &style->tooltip_border);
+	NK_LOVE_STYLE_COMPILE("popup border", float, &style->popup_border);
+	NK_LOVE_STYLE_COMPILE("rounding", float, &style->rounding);
+	NK_LOVE_STYLE_COMPILE("spacing", vec2, &style->spacing);
+	NK_LOVE_STYLE_COMPILE("scrollbar size", vec2, &style->scrollbar_size);
+	NK_LOVE_STYLE_COMPILE("min size", vec2, &style->min_size);
+	NK_LOVE_STYLE_COMPILE("padding", vec2, &style->padding);
+	NK_LOVE_STYLE_COMPILE("group padding", vec2, &style->group_padding);
+	NK_LOVE_STYLE_COMPILE("popup padding", vec2, &style->popup_padding);
+	NK_LOVE_STYLE_COMPILE("combo padding", vec2, &style->combo_padding);
+	NK_LOVE_STYLE_COMPILE("contextual padding", vec2, &style->contextual_padding);
+	NK_LOVE_STYLE_COMPILE("menu padding", vec2, &style->menu_padding);
+	NK_LOVE_STYLE_COMPILE("tooltip padding", vec2, &style->tooltip_padding);
 }
 
-static int nk_love_style_push(lua_State *L)
+/*
+ * Compiles the style table at index 2 for the context at index 1 and
+ * replaces it with the compiled style.
+ */
+static struct nk_love_style *nk_love_style_compile(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 2);
 	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
 	if (!lua_istable(L, 2))
 		luaL_typerror(L, 2, "table");
+	struct nk_love_style *style = lua_newuserdata(L, sizeof(struct nk_love_style));
+	nk_love_assert_alloc(L, style);
+	memset(style, 0, sizeof(struct nk_love_style));
+	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
+	lua_getfield(L, -1, "style");
+	lua_setmetatable(L, -3);
+	lua_pop(L, 1);
+	lua_newtable(L);
+	lua_setfenv(L, -2);
+	lua_insert(L, 2);
 	int outOfContext = (context == NULL);
 	if (outOfContext)
 		context = ctx;
-	lua_newtable(L);
-	lua_insert(L, 2);
-	NK_LOVE_STYLE_PUSH("font", font, &ctx->nkctx.style.font);
-	NK_LOVE_STYLE_PUSH("text", text, &ctx->nkctx.style.text);
-	NK_LOVE_STYLE_PUSH("button", button, &ctx->nkctx.style.button);
-	NK_LOVE_STYLE_PUSH("contextual button", button, &ctx->nkctx.style.contextual_button);
-	NK_LOVE_STYLE_PUSH("menu button", button, &ctx->nkctx.style.menu_button);
-	NK_LOVE_STYLE_PUSH("option", toggle, &ctx->nkctx.style.option);
-	NK_LOVE_STYLE_PUSH("checkbox", toggle, &ctx->nkctx.style.checkbox);
-	NK_LOVE_STYLE_PUSH("selectable", selectable, &ctx->nkctx.style.selectable);
-	NK_LOVE_STYLE_PUSH("slider", slider, &ctx->nkctx.style.slider);
-	NK_LOVE_STYLE_PUSH("progress", progress, &ctx->nkctx.style.progress);
-	NK_LOVE_STYLE_PUSH("property", property, &ctx->nkctx.style.property);
-	NK_LOVE_STYLE_PUSH("edit", edit, &ctx->nkctx.style.edit);
-	NK_LOVE_STYLE_PUSH("chart", chart, &ctx->nkctx.style.chart);
-	NK_LOVE_STYLE_PUSH("scrollh", scrollbar, &ctx->nkctx.style.scrollh);
-	NK_LOVE_STYLE_PUSH("scrollv", scrollbar, &ctx->nkctx.style.scrollv);
-	NK_LOVE_STYLE_PUSH("tab", tab, &ctx->nkctx.style.tab);
-	NK_LOVE_STYLE_PUSH("combo", combo, &ctx->nkctx.style.combo);
-	NK_LOVE_STYLE_PUSH("window", window, &ctx->nkctx.style.window);
-	lua_pop(L, 1);
-	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
-	lua_pushlightuserdata(L, ctx);
-	lua_gettable(L, -2);
-	lua_getfield(L, -1, "stack");
-	size_t stack_size = lua_objlen(L, -1);
-	lua_pushvalue(L, 2);
-	lua_rawseti(L, -2, stack_size + 1);
+	NK_LOVE_STYLE_COMPILE("font", font, &ctx->nkctx.style.font);
+	NK_LOVE_STYLE_COMPILE("text", text, &ctx->nkctx.style.text);
+	NK_LOVE_STYLE_COMPILE("button", button, &ctx->nkctx.style.button);
+	NK_LOVE_STYLE_COMPILE("contextual button", button, &ctx->nkctx.style.contextual_button);
+	NK_LOVE_STYLE_COMPILE("menu button", button, &ctx->nkctx.style.menu_button);
+	NK_LOVE_STYLE_COMPILE("option", toggle, &ctx->nkctx.style.option);
+	NK_LOVE_STYLE_COMPILE("checkbox", toggle, &ctx->nkctx.style.checkbox);
+	NK_LOVE_STYLE_COMPILE("selectable", selectable, &ctx->nkctx.style.selectable);
+	NK_LOVE_STYLE_COMPILE("slider", slider, &ctx->nkctx.style.slider);
+	NK_LOVE_STYLE_COMPILE("progress", progress, &ctx->nkctx.style.progress);
+	NK_LOVE_STYLE_COMPILE("property", property, &ctx->nkctx.style.property);
+	NK_LOVE_STYLE_COMPILE("edit", edit, &ctx->nkctx.style.edit);
+	NK_LOVE_STYLE_COMPILE("chart", chart, &ctx->nkctx.style.chart);
+	NK_LOVE_STYLE_COMPILE("scrollh", scrollbar, &ctx->nkctx.style.scrollh);
+	NK_LOVE_STYLE_COMPILE("scrollv", scrollbar, &ctx->nkctx.style.scrollv);
+	NK_LOVE_STYLE_COMPILE("tab", tab, &ctx->nkctx.style.tab);
+	NK_LOVE_STYLE_COMPILE("combo", combo, &ctx->nkctx.style.combo);
+	NK_LOVE_STYLE_COMPILE("window", window, &ctx->nkctx.style.window);
 	if (outOfContext)
 		context = NULL;
+	lua_pop(L, 1);
+	return style;
+}
+
+static void nk_love_style_apply(lua_State *L, struct nk_love_context *ctx, int index)
+{
+	struct nk_love_style *style = lua_touserdata(L, index);
+	nk_love_assert(L, ctx->style_depth < NK_LOVE_MAX_STYLE_DEPTH, "%s: style stack overflow");
+	if (ctx->style_save_count + style->count > ctx->style_save_capacity) {
+		int capacity = NK_MAX(ctx->style_save_capacity * 2, ctx->style_save_count + style->count);
+		struct nk_love_style_entry *saves = realloc(ctx->style_saves,
+			sizeof(struct nk_love_style_entry) * capacity);
+		nk_love_assert_alloc(L, saves);
+		ctx->style_saves = saves;
+		ctx->style_save_capacity = capacity;
+	}
+	ctx->style_marks[ctx->style_depth++] = ctx->style_save_count;
+	char *base = (char *) &ctx->nkctx.style;
+	int i, env = 0;
+	for (i = 0; i < style->count; ++i) {
+		const struct nk_love_style_entry *entry = &style->entries[i];
+		union nk_love_style_value value = entry->value;
+		if (entry->ref) {
+			if (!env) {
+				lua_getfenv(L, index);
+				env = 1;
+			}
+			lua_rawgeti(L, -1, entry->ref);
+			if (entry->kind == NK_LOVE_STYLE_FONT)
+				value.font = &nk_love_checkFont(L, -1)->font;
+			else
+				nk_love_checkImage(L, -1, &value.item.data.image);
+			lua_pop(L, 1);
+		}
+		size_t size = nk_love_style_sizes[entry->kind];
+		struct nk_love_style_entry *save = &ctx->style_saves[ctx->style_save_count++];
+		save->kind = entry->kind;
+		save->offset = entry->offset;
+		save->ref = 0;
+		memcpy(&save->value, base + entry->offset, size);
+		memcpy(base + entry->offset, &value, size);
+	}
+	if (env)
+		lua_pop(L, 1);
+}
+
+static int nk_love_new_style(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	nk_love_style_compile(L);
+	return 1;
+}
+
+static int nk_love_style_gc(lua_State *L)
+{
+	struct nk_love_style *style = lua_touserdata(L, 1);
+	free(style->entries);
 	return 0;
 }
 
-static int nk_love_style_pop(lua_State *L)
+static int nk_love_style_push(lua_State *L)
 {
-	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
 	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	if (lua_istable(L, 2))
+		nk_love_style_compile(L);
+	else
+		nk_love_checkstyle(L, 2);
 	int outOfContext = (context == NULL);
+	if (context != ctx)
+		ctx->style_generation++;
 	if (outOfContext)
 		context = ctx;
-	lua_getfield(L, LUA_REGISTRYINDEX, "nuklear");
-	lua_pushlightuserdata(L, ctx);
-	lua_gettable(L, -2);
-	lua_getfield(L, -1, "stack");
-	size_t stack_size = lua_objlen(L, -1);
-	lua_rawgeti(L, -1, stack_size);
-	lua_pushnil(L);
-	lua_rawseti(L, -3, stack_size);
-	stack_size = lua_objlen(L, -1);
-	size_t i;
-	for (i = stack_size; i > 0; --i) {
-		lua_rawgeti(L, -1, i);
-		const char *type = lua_tostring(L, -1);
-		if (!strcmp(type, "color")) {
-			nk_style_pop_color(&ctx->nkctx);
-		} else if (!strcmp(type, "vec2")) {
-			nk_style_pop_vec2(&ctx->nkctx);
-		} else if (!strcmp(type, "item")) {
-			nk_style_pop_style_item(&ctx->nkctx);
-		} else if (!strcmp(type, "flags")) {
-			nk_style_pop_flags(&ctx->nkctx);
-		} else if (!strcmp(type, "float")) {
-			nk_style_pop_float(&ctx->nkctx);
-		} else if (!strcmp(type, "font")) {
-			nk_style_pop_font(&ctx->nkctx);
-		} else {
-			const char *msg = lua_pushfstring(L, "%%s: bad style item type '%s'", lua_tostring(L, -1));
-			nk_love_assert(L, 0, msg);
-		}
-		lua_pop(L, 1);
-	}
+	nk_love_style_apply(L, ctx, 2);
 	if (outOfContext)
 		context = NULL;
 	return 0;
 }
 
+static int nk_love_style_pop(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	if (ctx->style_depth == 0)
+		return 0;
+	int mark = ctx->style_marks[--ctx->style_depth];
+	if (context != ctx) {
+		ctx->style_generation++;
+	} else if (ctx->style_depth < ctx->style_frame_depth) {
+		ctx->style_frame_depth = ctx->style_depth;
+		ctx->style_generation++;
+	}
+	char *base = (char *) &ctx->nkctx.style;
+	while (ctx->style_save_count > mark) {
+		struct nk_love_style_entry *save = &ctx->style_saves[--ctx->style_save_count];
+		memcpy(base + save->offset, &save->value, nk_love_style_sizes[save->kind]);
+	}
+	return 0;
+}
+
 static int nk_love_style(lua_State *L)
 {
 	nk_love_assert(L, lua_checkstack(L, 3), "%s: failed to allocate stack space");
@@ -4240,11 +7235,80 @@ static int nk_love_spacing(lua_State *L)
 	return 0;
 }
 
+static int nk_love_pen_set_color(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	ctx->pen.color = nk_love_checkcolor(L, 2);
+	return 0;
+}
+
+static int nk_love_pen_get_color(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	char color_string[10];
+	nk_love_color(ctx->pen.color.r, ctx->pen.color.g, ctx->pen.color.b, ctx->pen.color.a, color_string);
+	lua_pushstring(L, color_string);
+	return 1;
+}
+
+static int nk_love_pen_set_line_width(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	ctx->pen.line_width = luaL_checknumber(L, 2);
+	return 0;
+}
+
+static int nk_love_pen_get_line_width(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	lua_pushnumber(L, ctx->pen.line_width);
+	return 1;
+}
+
+static int nk_love_pen_push(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	nk_love_assert(L, ctx->pen_count < NK_LOVE_MAX_PENS, "%s: pen stack overflow");
+	ctx->pens[ctx->pen_count++] = ctx->pen;
+	return 0;
+}
+
+static int nk_love_pen_pop(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	nk_love_assert(L, ctx->pen_count > 0, "%s: pen stack underflow");
+	ctx->pen = ctx->pens[--ctx->pen_count];
+	return 0;
+}
+
+static int nk_love_set_pen_sync(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 2);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	ctx->pen_sync = nk_love_checkboolean(L, 2);
+	return 0;
+}
+
+static int nk_love_get_pen_sync(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) == 1);
+	struct nk_love_context *ctx = nk_love_checkcontext(L, 1);
+	lua_pushboolean(L, ctx->pen_sync);
+	return 1;
+}
+
 static int nk_love_line(lua_State *L)
 {
 	int argc = lua_gettop(L);
 	nk_love_assert_argc(L, argc >= 5 && argc % 2 == 1);
 	nk_love_assert_context(L, 1);
+	float *points = nk_love_arena_alloc(L, sizeof(float) * (argc - 1));
 	int i;
 	for (i = 0; i < argc - 1; ++i) {
 		nk_love_assert(L, lua_isnumber(L, i + 2), "%s: point coordinates should be numbers");
@@ -4252,11 +7316,132 @@ static int nk_love_line(lua_State *L)
 	}
 	float line_thickness;
 	struct nk_color color;
-	nk_love_getGraphics(L, &line_thickness, &color);
+	nk_love_getPen(&line_thickness, &color);
 	nk_stroke_polyline(&context->nkctx.current->buffer, points, (argc - 1) / 2, line_thickness, color);
 	return 0;
 }
 
+/* Batch color components range from 0 to 255, as in {r, g, b, a} color tables. */
+static nk_byte nk_love_sample_component(lua_State *L, const struct nk_love_samples *colors, int i)
+{
+	float c = nk_love_sample(L, colors, i);
+	return (nk_byte) (NK_CLAMP(0.0f, c, 255.0f) + 0.5f);
+}
+
+static struct nk_color nk_love_sample_color(lua_State *L, const struct nk_love_samples *colors, int i)
+{
+	struct nk_color color;
+	color.r = nk_love_sample_component(L, colors, i * 4);
+	color.g = nk_love_sample_component(L, colors, i * 4 + 1);
+	color.b = nk_love_sample_component(L, colors, i * 4 + 2);
+	color.a = nk_love_sample_component(L, colors, i * 4 + 3);
+	return color;
+}
+
+/*
+ * Batched primitives take their coordinates, and optionally one RGBA color
+ * per primitive, as samples (see nk_love_checksamples). Without colors every
+ * primitive uses the current pen, which is read once per call.
+ */
+static int nk_love_checkbatchcolors(lua_State *L, int index, int count,
+	struct nk_love_samples *colors)
+{
+	int argc = lua_gettop(L);
+	if (index > argc || lua_isnil(L, index)) {
+		nk_love_assert_argc(L, argc <= index);
+		return 0;
+	}
+	int next = nk_love_checksamples(L, index, colors);
+	nk_love_assert_argc(L, argc == next - 1);
+	luaL_argcheck(L, colors->count >= count * 4, index, "not enough colors");
+	return 1;
+}
+
+static int nk_love_lines(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 2);
+	nk_love_assert_context(L, 1);
+	struct nk_love_samples coords, colors;
+	int next = nk_love_checksamples(L, 2, &coords);
+	luaL_argcheck(L, coords.count % 4 == 0, 2, "line coordinates should come in fours");
+	int i, count = coords.count / 4;
+	int use_colors = nk_love_checkbatchcolors(L, next, count, &colors);
+	float line_thickness;
+	struct nk_color color;
+	nk_love_getPen(&line_thickness, &color);
+	struct nk_command_buffer *out = &context->nkctx.current->buffer;
+	for (i = 0; i < count; ++i) {
+		if (use_colors)
+			color = nk_love_sample_color(L, &colors, i);
+		nk_stroke_line(out, nk_love_sample(L, &coords, i * 4), nk_love_sample(L, &coords, i * 4 + 1),
+			nk_love_sample(L, &coords, i * 4 + 2), nk_love_sample(L, &coords, i * 4 + 3),
+			line_thickness, color);
+	}
+	return 0;
+}
+
+static int nk_love_rects(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 3);
+	nk_love_assert_context(L, 1);
+	enum nk_love_draw_mode mode = nk_love_checkdraw(L, 2);
+	struct nk_love_samples coords, colors;
+	int next = nk_love_checksamples(L, 3, &coords);
+	luaL_argcheck(L, coords.count % 4 == 0, 3, "rectangles should come in fours");
+	int i, count = coords.count / 4;
+	int use_colors = nk_love_checkbatchcolors(L, next, count, &colors);
+	float line_thickness;
+	struct nk_color color;
+	nk_love_getPen(&line_thickness, &color);
+	struct nk_command_buffer *out = &context->nkctx.current->buffer;
+	for (i = 0; i < count; ++i) {
+		if (use_colors)
+			color = nk_love_sample_color(L, &colors, i);
+		struct nk_rect rect = nk_rect(nk_love_sample(L, &coords, i * 4), nk_love_sample(L, &coords, i * 4 + 1),
+			nk_love_sample(L, &coords, i * 4 + 2), nk_love_sample(L, &coords, i * 4 + 3));
+		if (mode == NK_LOVE_FILL)
+			nk_fill_rect(out, rect, 0, color);
+		else if (mode == NK_LOVE_LINE)
+			nk_stroke_rect(out, rect, 0, line_thickness, color);
+	}
+	return 0;
+}
+
+static int nk_love_polygons(lua_State *L)
+{
+	nk_love_assert_argc(L, lua_gettop(L) >= 4);
+	nk_love_assert_context(L, 1);
+	enum nk_love_draw_mode mode = nk_love_checkdraw(L, 2);
+	struct nk_love_samples coords, counts, colors;
+	int next = nk_love_checksamples(L, 3, &coords);
+	next = nk_love_checksamples(L, next, &counts);
+	int use_colors = nk_love_checkbatchcolors(L, next, counts.count, &colors);
+	float line_thickness;
+	struct nk_color color;
+	nk_love_getPen(&line_thickness, &color);
+	struct nk_command_buffer *out = &context->nkctx.current->buffer;
+	int i, j, offset = 0;
+	for (i = 0; i < counts.count; ++i) {
+		int n = (int) nk_love_sample(L, &counts, i);
+		nk_love_assert(L, n >= 3, "%s: polygons need at least three points");
+		nk_love_assert(L, (offset + n) * 2 <= coords.count, "%s: not enough polygon coordinates");
+		float *vertices = (float *) coords.data + offset * 2;
+		if (coords.data == NULL) {
+			vertices = nk_love_arena_alloc(L, sizeof(float) * n * 2);
+			for (j = 0; j < n * 2; ++j)
+				vertices[j] = nk_love_sample(L, &coords, offset * 2 + j);
+		}
+		if (use_colors)
+			color = nk_love_sample_color(L, &colors, i);
+		if (mode == NK_LOVE_FILL)
+			nk_fill_polygon(out, vertices, n, color);
+		else if (mode == NK_LOVE_LINE)
+			nk_stroke_polygon(out, vertices, n, line_thickness, color);
+		offset += n;
+	}
+	return 0;
+}
+
 static int nk_love_curve(lua_State *L)
 {
 	nk_love_assert_argc(L, lua_gettop(L) == 9);
@@ -4272,7 +7457,7 @@ static int nk_love_curve(lua_State *L)
 	float by = luaL_checknumber(L, 9);
 	float line_thickness;
 	struct nk_color color;
-	nk_love_getGraphics(L, &line_thickness, &color);
+	nk_love_getPen(&line_thickness, &color);
 	nk_stroke_curve(&context->nkctx.current->buffer, ax, ay, ctrl0x, ctrl0y, ctrl1x, ctrl1y, bx, by, line_thickness, color);
 	return 0;
 }
@@ -4283,6 +7468,7 @@ static int nk_love_polygon(lua_State *L)
 	nk_love_assert_argc(L, argc >= 8 && argc % 2 == 0);
 	nk_love_assert_context(L, 1);
 	enum nk_love_draw_mode mode = nk_love_checkdraw(L, 2);
+	float *points = nk_love_arena_alloc(L, sizeof(float) * (argc - 2));
 	int i;
 	for (i = 0; i < argc - 2; ++i) {
 		nk_love_assert(L, lua_isnumber(L, i + 3), "%s: point coordinates should be numbers");
@@ -4290,7 +7476,7 @@ static int nk_love_polygon(lua_State *L)
 	}
 	float line_thickness;
 	struct nk_color color;
-	nk_love_getGraphics(L, &line_thickness, &color);
+	nk_love_getPen(&line_thickness, &color);
 	if (mode == NK_LOVE_FILL)
 		nk_fill_polygon(&context->nkctx.current->buffer, points, (argc - 2) / 2, color);
 	else if (mode == NK_LOVE_LINE)
@@ -4308,7 +7494,7 @@ static int nk_love_circle(lua_State *L)
 	float r = luaL_checknumber(L, 5);
 	float line_thickness;
 	struct nk_color color;
-	nk_love_getGraphics(L, &line_thickness, &color);
+	nk_love_getPen(&line_thickness, &color);
 	if (mode == NK_LOVE_FILL)
 		nk_fill_circle(&context->nkctx.current->buffer, nk_rect(x - r, y - r, r * 2, r * 2), color);
 	else if (mode == NK_LOVE_LINE)
@@ -4327,7 +7513,7 @@ static int nk_love_ellipse(lua_State *L)
 	float ry = luaL_checknumber(L, 6);
 	float line_thickness;
 	struct nk_color color;
-	nk_love_getGraphics(L, &line_thickness, &color);
+	nk_love_getPen(&line_thickness, &color);
 	if (mode == NK_LOVE_FILL)
 		nk_fill_circle(&context->nkctx.current->buffer, nk_rect(x - rx, y - ry, rx * 2, ry * 2), color);
 	else if (mode == NK_LOVE_LINE)
@@ -4347,7 +7533,7 @@ static int nk_love_arc(lua_State *L)
 	float a1 = luaL_checknumber(L, 7);
 	float line_thickness;
 	struct nk_color color;
-	nk_love_getGraphics(L, &line_thickness, &color);
+	nk_love_getPen(&line_thickness, &color);
 	if (mode == NK_LOVE_FILL)
 		nk_fill_arc(&context->nkctx.current->buffer, cx, cy, r, a0, a1, color);
 	else if (mode == NK_LOVE_LINE)
@@ -4367,7 +7553,7 @@ static int nk_love_rect_multi_color(lua_State *L)
 	struct nk_color topRight = nk_love_checkcolor(L, 7);
 	struct nk_color bottomLeft = nk_love_checkcolor(L, 8);
 	struct nk_color bottomRight = nk_love_checkcolor(L, 9);
-	nk_fill_rect_multi_color(&context->nkctx.current->buffer, nk_rect(x, y, w, h), topLeft, topRight, bottomLeft, bottomRight);
+	nk_fill_rect_multi_color(&context->nkctx.current->buffer, nk_rect(x, y, w, h), topLeft, topRight, bottomRight, bottomLeft);
 	return 0;
 }
 
@@ -4392,15 +7578,13 @@ static int nk_love_text(lua_State *L)
 	float y = luaL_checknumber(L, 4);
 	float w = luaL_checknumber(L, 5);
 	float h = luaL_checknumber(L, 6);
-	lua_getglobal(L, "love");
-	lua_getfield(L, -1, "graphics");
-	lua_getfield(L, -1, "getFont");
-	lua_call(L, 0, 1);
-	nk_love_checkFont(L, -1, &context->fonts[context->font_count]);
+	const struct nk_user_font *font = context->pen_font;
+	if (font == NULL)
+		font = context->nkctx.style.font;
 	float line_thickness;
 	struct nk_color color;
-	nk_love_getGraphics(L, &line_thickness, &color);
-	nk_draw_text(&context->nkctx.current->buffer, nk_rect(x, y, w, h), text, strlen(text), &context->fonts[context->font_count++].font, nk_rgba(0, 0, 0, 0), color);
+	nk_love_getPen(&line_thickness, &color);
+	nk_draw_text(&context->nkctx.current->buffer, nk_rect(x, y, w, h), text, strlen(text), font, nk_rgba(0, 0, 0, 0), color);
 	return 0;
 }
 
@@ -4494,10 +7678,6 @@ static int nk_love_input_is_hovered(lua_State *L)
 
 LUALIB_API int luaopen_nuklear(lua_State *L)
 {
-	edit_buffer = nk_love_malloc(L, NK_LOVE_EDIT_BUFFER_LEN);
-	combobox_items = nk_love_malloc(L, sizeof(char*) * NK_LOVE_COMBOBOX_MAX_ITEMS);
-	points = nk_love_malloc(L, sizeof(float) * NK_LOVE_MAX_POINTS * 2);
-
 	lua_newtable(L);
 	lua_pushvalue(L, -1);
 	lua_setfield(L, LUA_REGISTRYINDEX, "nuklear");
@@ -4506,6 +7686,17 @@ LUALIB_API int luaopen_nuklear(lua_State *L)
 	nk_love_assert(L, lua_istable(L, -1), "LOVE-Nuklear requires LOVE environment");
 	lua_pop(L, 1);
 
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_pushstring(L, "k");
+	lua_setfield(L, -2, "__mode");
+	lua_setmetatable(L, -2);
+	lua_setfield(L, -2, "metrics");
+	lua_newtable(L);
+	NK_LOVE_REGISTER("__gc", nk_love_metrics_gc);
+	lua_setfield(L, -2, "metricsmeta");
+	nk_love_intern_enums(L);
+
 	lua_newtable(L);
 
 	NK_LOVE_REGISTER("keypressed", nk_love_keypressed);
@@ -4517,6 +7708,12 @@ LUALIB_API int luaopen_nuklear(lua_State *L)
 	NK_LOVE_REGISTER("wheelmoved", nk_love_wheelmoved);
 
 	NK_LOVE_REGISTER("draw", nk_love_draw);
+	NK_LOVE_REGISTER("setRenderMode", nk_love_set_render_mode);
+	NK_LOVE_REGISTER("getRenderMode", nk_love_get_render_mode);
+	NK_LOVE_REGISTER("setTessellationQuality", nk_love_set_tessellation_quality);
+	NK_LOVE_REGISTER("getTessellationQuality", nk_love_get_tessellation_quality);
+	NK_LOVE_REGISTER("setWindowCaching", nk_love_set_window_caching);
+	NK_LOVE_REGISTER("frameStats", nk_love_frame_stats);
 
 	NK_LOVE_REGISTER("frameBegin", nk_love_frame_begin);
 	NK_LOVE_REGISTER("frameEnd", nk_love_frame_end);
@@ -4579,6 +7776,10 @@ LUALIB_API int luaopen_nuklear(lua_State *L)
 	NK_LOVE_REGISTER("groupGetScroll", nk_love_group_get_scroll);
 	NK_LOVE_REGISTER("groupSetScroll", nk_love_group_set_scroll);
 
+	NK_LOVE_REGISTER("listViewBegin", nk_love_list_view_begin);
+	NK_LOVE_REGISTER("listViewEnd", nk_love_list_view_end);
+	NK_LOVE_REGISTER("listView", nk_love_list_view);
+
 	NK_LOVE_REGISTER("treePush", nk_love_tree_push);
 	NK_LOVE_REGISTER("treePop", nk_love_tree_pop);
 	NK_LOVE_REGISTER("tree", nk_love_tree);
@@ -4598,9 +7799,16 @@ LUALIB_API int luaopen_nuklear(lua_State *L)
 	NK_LOVE_REGISTER("selectable", nk_love_selectable);
 	NK_LOVE_REGISTER("slider", nk_love_slider);
 	NK_LOVE_REGISTER("progress", nk_love_progress);
+	NK_LOVE_REGISTER("chart", nk_love_chart);
 	NK_LOVE_REGISTER("colorPicker", nk_love_color_picker);
 	NK_LOVE_REGISTER("property", nk_love_property);
 	NK_LOVE_REGISTER("edit", nk_love_edit);
+	NK_LOVE_REGISTER("newTextBuffer", nk_love_new_text_buffer);
+	NK_LOVE_REGISTER("newDocument", nk_love_new_document);
+	NK_LOVE_REGISTER("newItemList", nk_love_new_item_list);
+	NK_LOVE_REGISTER("newSeries", nk_love_new_series);
+	NK_LOVE_REGISTER("newStyle", nk_love_new_style);
+	NK_LOVE_REGISTER("document", nk_love_document);
 	NK_LOVE_REGISTER("editFocus", nk_love_edit_focus);
 	NK_LOVE_REGISTER("editUnfocus", nk_love_edit_unfocus);
 	NK_LOVE_REGISTER("popupBegin", nk_love_popup_begin);
@@ -4612,6 +7820,7 @@ LUALIB_API int luaopen_nuklear(lua_State *L)
 	NK_LOVE_REGISTER("combobox", nk_love_combobox);
 	NK_LOVE_REGISTER("comboboxBegin", nk_love_combobox_begin);
 	NK_LOVE_REGISTER("comboboxItem", nk_love_combobox_item);
+	NK_LOVE_REGISTER("comboboxItems", nk_love_combobox_items);
 	NK_LOVE_REGISTER("comboboxClose", nk_love_combobox_close);
 	NK_LOVE_REGISTER("comboboxEnd", nk_love_combobox_end);
 	NK_LOVE_REGISTER("contextualBegin", nk_love_contextual_begin);
@@ -4650,9 +7859,20 @@ LUALIB_API int luaopen_nuklear(lua_State *L)
 	NK_LOVE_REGISTER("widgetIsMouseReleased", nk_love_widget_is_mouse_released);
 	NK_LOVE_REGISTER("spacing", nk_love_spacing);
 
+	NK_LOVE_REGISTER("setColor", nk_love_pen_set_color);
+	NK_LOVE_REGISTER("getColor", nk_love_pen_get_color);
+	NK_LOVE_REGISTER("setLineWidth", nk_love_pen_set_line_width);
+	NK_LOVE_REGISTER("getLineWidth", nk_love_pen_get_line_width);
+	NK_LOVE_REGISTER("penPush", nk_love_pen_push);
+	NK_LOVE_REGISTER("penPop", nk_love_pen_pop);
+	NK_LOVE_REGISTER("setPenSync", nk_love_set_pen_sync);
+	NK_LOVE_REGISTER("getPenSync", nk_love_get_pen_sync);
 	NK_LOVE_REGISTER("line", nk_love_line);
 	NK_LOVE_REGISTER("curve", nk_love_curve);
 	NK_LOVE_REGISTER("polygon", nk_love_polygon);
+	NK_LOVE_REGISTER("lines", nk_love_lines);
+	NK_LOVE_REGISTER("rects", nk_love_rects);
+	NK_LOVE_REGISTER("polygons", nk_love_polygons);
 	NK_LOVE_REGISTER("circle", nk_love_circle);
 	NK_LOVE_REGISTER("ellipse", nk_love_ellipse);
 	NK_LOVE_REGISTER("arc", nk_love_arc);
@@ -4669,14 +7889,81 @@ LUALIB_API int luaopen_nuklear(lua_State *L)
 	NK_LOVE_REGISTER("inputIsHovered", nk_love_input_is_hovered);
 
 	lua_newtable(L);
+	context_metatable = lua_topointer(L, -1);
 	lua_pushvalue(L, -1);
 	lua_setfield(L, -4, "metatable");
 	NK_LOVE_REGISTER("__gc", nk_love_destroy);
 	lua_pushvalue(L, -2);
 	lua_setfield(L, -2, "__index");
 
+	lua_newtable(L);
+	NK_LOVE_REGISTER("getText", nk_love_text_buffer_get_text);
+	NK_LOVE_REGISTER("setText", nk_love_text_buffer_set_text);
+	NK_LOVE_REGISTER("getLength", nk_love_text_buffer_get_length);
+	NK_LOVE_REGISTER("getVersion", nk_love_text_buffer_get_version);
+	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -6, "textbuffer");
+	NK_LOVE_REGISTER("__gc", nk_love_text_buffer_gc);
+	lua_pushvalue(L, -2);
+	lua_setfield(L, -2, "__index");
+	lua_pop(L, 2);
+
+	lua_newtable(L);
+	NK_LOVE_REGISTER("getText", nk_love_document_get_text);
+	NK_LOVE_REGISTER("setText", nk_love_document_set_text);
+	NK_LOVE_REGISTER("getLength", nk_love_document_get_length);
+	NK_LOVE_REGISTER("getLineCount", nk_love_document_get_line_count);
+	NK_LOVE_REGISTER("getLine", nk_love_document_get_line);
+	NK_LOVE_REGISTER("getVersion", nk_love_document_get_version);
+	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -6, "document");
+	NK_LOVE_REGISTER("__gc", nk_love_document_gc);
+	lua_pushvalue(L, -2);
+	lua_setfield(L, -2, "__index");
+	lua_pop(L, 2);
+
+	lua_newtable(L);
+	NK_LOVE_REGISTER("setItems", nk_love_item_list_set_items);
+	NK_LOVE_REGISTER("getCount", nk_love_item_list_get_count);
+	NK_LOVE_REGISTER("getItem", nk_love_item_list_get_item);
+	NK_LOVE_REGISTER("setFilter", nk_love_item_list_set_filter);
+	NK_LOVE_REGISTER("getFilter", nk_love_item_list_get_filter);
+	NK_LOVE_REGISTER("getMatchCount", nk_love_item_list_get_match_count);
+	NK_LOVE_REGISTER("getMatch", nk_love_item_list_get_match);
+	NK_LOVE_REGISTER("getVersion", nk_love_item_list_get_version);
+	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -6, "itemlist");
+	NK_LOVE_REGISTER("__gc", nk_love_item_list_gc);
+	lua_pushvalue(L, -2);
+	lua_setfield(L, -2, "__index");
+	lua_pop(L, 2);
+
+	lua_newtable(L);
+	NK_LOVE_REGISTER("setSamples", nk_love_series_set_samples);
+	NK_LOVE_REGISTER("getCount", nk_love_series_get_count);
+	NK_LOVE_REGISTER("getRange", nk_love_series_get_range);
+	NK_LOVE_REGISTER("getVersion", nk_love_series_get_version);
+	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -6, "series");
+	NK_LOVE_REGISTER("__gc", nk_love_series_gc);
+	lua_pushvalue(L, -2);
+	lua_setfield(L, -2, "__index");
+	lua_pop(L, 2);
+
+	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	lua_setfield(L, -5, "style");
+	NK_LOVE_REGISTER("__gc", nk_love_style_gc);
+	lua_pop(L, 1);
+
 	lua_newtable(L);
 	NK_LOVE_REGISTER("newUI", nk_love_new_ui);
+	NK_LOVE_REGISTER("invalidateGraphics", nk_love_invalidate);
+	NK_LOVE_REGISTER("flags", nk_love_flags);
 	NK_LOVE_REGISTER("colorRGBA", nk_love_color_rgba);
 	NK_LOVE_REGISTER("colorHSVA", nk_love_color_hsva);
 	NK_LOVE_REGISTER("colorParseRGBA", nk_love_color_parse_rgba);